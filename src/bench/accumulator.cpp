@@ -0,0 +1,58 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chainparams.h>
+#include <libzerocoin/Accumulator.h>
+
+#include <vector>
+
+// Accumulating does not validate the values, so random values in the pubcoin range are enough here
+static std::vector<CBigNum> RandomPubcoins(const libzerocoin::ZerocoinParams* params, size_t nMints)
+{
+    std::vector<CBigNum> vPubcoins;
+    for (size_t i = 0; i < nMints; i++)
+        vPubcoins.emplace_back(CBigNum::randBignum(params->accumulatorParams.maxCoinValue));
+    return vPubcoins;
+}
+
+static void AccumulateSerial(benchmark::State& state, size_t nMints)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    libzerocoin::ZerocoinParams* params = chainParams->Zerocoin_Params();
+    std::vector<CBigNum> vPubcoins = RandomPubcoins(params, nMints);
+
+    while (state.KeepRunning()) {
+        libzerocoin::Accumulator accumulator(params, libzerocoin::CoinDenomination::ZQ_TEN);
+        for (const CBigNum& bnPubcoin : vPubcoins)
+            accumulator.increment(bnPubcoin);
+    }
+}
+
+static void AccumulateBatch(benchmark::State& state, size_t nMints)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    libzerocoin::ZerocoinParams* params = chainParams->Zerocoin_Params();
+    std::vector<CBigNum> vPubcoins = RandomPubcoins(params, nMints);
+
+    while (state.KeepRunning()) {
+        libzerocoin::Accumulator accumulator(params, libzerocoin::CoinDenomination::ZQ_TEN);
+        accumulator.incrementBatch(vPubcoins);
+    }
+}
+
+static void AccumulateSerial10(benchmark::State& state) { AccumulateSerial(state, 10); }
+static void AccumulateSerial100(benchmark::State& state) { AccumulateSerial(state, 100); }
+static void AccumulateSerial1000(benchmark::State& state) { AccumulateSerial(state, 1000); }
+static void AccumulateBatch10(benchmark::State& state) { AccumulateBatch(state, 10); }
+static void AccumulateBatch100(benchmark::State& state) { AccumulateBatch(state, 100); }
+static void AccumulateBatch1000(benchmark::State& state) { AccumulateBatch(state, 1000); }
+
+BENCHMARK(AccumulateSerial10, 20);
+BENCHMARK(AccumulateSerial100, 2);
+BENCHMARK(AccumulateSerial1000, 1);
+BENCHMARK(AccumulateBatch10, 20);
+BENCHMARK(AccumulateBatch100, 2);
+BENCHMARK(AccumulateBatch1000, 1);
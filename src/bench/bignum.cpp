@@ -0,0 +1,52 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chainparams.h>
+#include <libzerocoin/Params.h>
+
+// Throughput of the CBigNum operations that zerocoin proofs are made of, over the serial number SoK group
+static void BigNumMulMod(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const libzerocoin::IntegerGroupParams& group = chainParams->Zerocoin_Params()->serialNumberSoKCommitmentGroup;
+    CBigNum a = CBigNum::randBignum(group.modulus);
+    const CBigNum b = CBigNum::randBignum(group.modulus);
+
+    while (state.KeepRunning()) {
+        a = a.mul_mod(b, group.modulus);
+    }
+}
+
+static void BigNumPowMod(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const libzerocoin::IntegerGroupParams& group = chainParams->Zerocoin_Params()->serialNumberSoKCommitmentGroup;
+    CBigNum a = CBigNum::randBignum(group.modulus);
+    const CBigNum x = CBigNum::randBignum(group.groupOrder);
+
+    while (state.KeepRunning()) {
+        a = a.pow_mod(x, group.modulus);
+    }
+}
+
+// The exponent arithmetic mod the group order, where most of the cost is in creating and destroying temporaries
+static void BigNumScalarOps(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const CBigNum& q = chainParams->Zerocoin_Params()->serialNumberSoKCommitmentGroup.groupOrder;
+    CBigNum a = CBigNum::randBignum(q);
+    const CBigNum b = CBigNum::randBignum(q);
+
+    while (state.KeepRunning()) {
+        a = (a.mul_mod(b, q) + b) % q;
+        if (a < CBigNum(0) || a.isOne())
+            a = b;
+    }
+}
+
+BENCHMARK(BigNumMulMod, 100 * 1000);
+BENCHMARK(BigNumPowMod, 200);
+BENCHMARK(BigNumScalarOps, 500 * 1000);
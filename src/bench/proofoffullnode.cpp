@@ -0,0 +1,52 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <clientversion.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <streams.h>
+#include <veil/proofoffullnode/proofoffullnode.h>
+
+#include <vector>
+
+/** Rounds run for every block validated, as in the main and test network parameters */
+static const int POFN_BENCH_ROUNDS = 4;
+
+// Time the proof of full node of one block: every iteration runs all rounds over a serialized block of nTx
+// transactions, the way a PoS block is checked against blocks read from disk.
+static void ProofOfFullNode(benchmark::State& state, size_t nTx)
+{
+    FastRandomContext rng(true);
+    CBlock block;
+    for (size_t i = 0; i < nTx; i++) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint(rng.rand256(), 0), CScript() << std::vector<unsigned char>(72, 1));
+        tx.vpout.emplace_back(MAKE_OUTPUT<CTxOutStandard>(1 * COIN, CScript() << std::vector<unsigned char>(25, 2)));
+        tx.vpout.emplace_back(MAKE_OUTPUT<CTxOutStandard>(2 * COIN, CScript() << std::vector<unsigned char>(25, 3)));
+        block.vtx.emplace_back(MakeTransactionRef(std::move(tx)));
+    }
+
+    CDataStream ssBlock(SER_DISK, CLIENT_VERSION);
+    ssBlock << block;
+    std::vector<uint8_t> vchBlock(ssBlock.begin(), ssBlock.end());
+    uint256 hashBlock = block.GetHash();
+    uint256 hashCommitToChain = rng.rand256();
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < POFN_BENCH_ROUNDS; i++) {
+            CDataStream ss(vchBlock, SER_DISK, CLIENT_VERSION);
+            uint256 hashMutatedRoot;
+            bool fRound = veil::GetProofOfFullNodeRound(ss, hashBlock, hashCommitToChain, i, hashMutatedRoot);
+            assert(fRound);
+            hashCommitToChain = hashMutatedRoot;
+        }
+    }
+}
+
+static void ProofOfFullNode_100(benchmark::State& state) { ProofOfFullNode(state, 100); }
+static void ProofOfFullNode_2000(benchmark::State& state) { ProofOfFullNode(state, 2000); }
+
+BENCHMARK(ProofOfFullNode_100, 100);
+BENCHMARK(ProofOfFullNode_2000, 10);
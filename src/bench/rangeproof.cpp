@@ -0,0 +1,94 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <amount.h>
+#include <checkqueue.h>
+#include <consensus/tx_verify.h>
+#include <random.h>
+#include <util.h>
+#include <veil/ringct/blind.h>
+
+#include <secp256k1_rangeproof.h>
+
+#include <boost/thread/thread.hpp>
+
+#include <vector>
+
+static const size_t PROOF_COUNT = 64;
+static const unsigned int QUEUE_BATCH_SIZE = 16;
+
+struct RangeProofSet
+{
+    std::vector<secp256k1_pedersen_commitment> vCommitments;
+    std::vector<std::vector<uint8_t> > vRangeproofs;
+
+    RangeProofSet()
+    {
+        if (!secp256k1_ctx_blind)
+            ECC_Start_Blinding();
+        InitRangeProofCache();
+
+        vCommitments.resize(PROOF_COUNT);
+        vRangeproofs.resize(PROOF_COUNT);
+        for (size_t i = 0; i < PROOF_COUNT; i++) {
+            uint256 blind = GetRandHash();
+            uint256 nonce = GetRandHash();
+            uint64_t nValue = 1 + GetRand(1000 * COIN);
+            assert(secp256k1_pedersen_commit(secp256k1_ctx_blind, &vCommitments[i], blind.begin(), nValue, secp256k1_generator_h));
+
+            uint64_t min_value = 0;
+            int ct_exponent = 2, ct_bits = 32;
+            SelectRangeProofParameters(nValue, min_value, ct_exponent, ct_bits);
+
+            size_t nRangeProofLen = 5134;
+            vRangeproofs[i].resize(nRangeProofLen);
+            assert(secp256k1_rangeproof_sign(secp256k1_ctx_blind, &vRangeproofs[i][0], &nRangeProofLen, min_value,
+                    &vCommitments[i], blind.begin(), nonce.begin(), ct_exponent, ct_bits, nValue, nullptr, 0, nullptr, 0,
+                    secp256k1_generator_h));
+            vRangeproofs[i].resize(nRangeProofLen);
+        }
+    }
+
+    std::vector<CRangeProofCheck> GetChecks() const
+    {
+        std::vector<CRangeProofCheck> vChecks;
+        for (size_t i = 0; i < PROOF_COUNT; i++)
+            vChecks.emplace_back(&vCommitments[i], &vRangeproofs[i], "bad-ctout-rangeproof-verify", false); // don't cache, every iteration must verify
+        return vChecks;
+    }
+};
+
+// Verify a block's worth of range proofs on the calling thread
+static void RangeProofVerifySerial(benchmark::State& state)
+{
+    RangeProofSet proofs;
+    while (state.KeepRunning()) {
+        std::vector<CRangeProofCheck> vChecks = proofs.GetChecks();
+        for (auto& check : vChecks)
+            assert(check());
+    }
+}
+
+// Verify the same proofs on a check queue using every core
+static void RangeProofVerifyQueue(benchmark::State& state)
+{
+    RangeProofSet proofs;
+    CCheckQueue<CRangeProofCheck> queue {QUEUE_BATCH_SIZE};
+    boost::thread_group tg;
+    for (int i = 0; i < GetNumCores() - 1; ++i) {
+        tg.create_thread([&]{queue.Thread();});
+    }
+    while (state.KeepRunning()) {
+        std::vector<CRangeProofCheck> vChecks = proofs.GetChecks();
+        CCheckQueueControl<CRangeProofCheck> control(&queue);
+        control.Add(vChecks);
+        assert(control.Wait());
+    }
+    tg.interrupt_all();
+    tg.join_all();
+}
+
+BENCHMARK(RangeProofVerifySerial, 10);
+BENCHMARK(RangeProofVerifyQueue, 10);
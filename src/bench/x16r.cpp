@@ -0,0 +1,126 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <crypto/x16r/x16r_4way.h>
+#include <hash.h>
+#include <primitives/block.h>
+#include <uint256.h>
+
+#include <vector>
+
+// Every iteration hashes X16R_4WAY_LANES inputs of nLen bytes: 80 for the header in the first X16R step, 64 for
+// the digest in all later steps. The scalar and multi-buffer timings of an algorithm can be compared directly.
+static void HashAlgoScalar(benchmark::State& state, int nAlgo, size_t nLen)
+{
+    unsigned char buf[X16R_4WAY_LANES][80] = {};
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < X16R_4WAY_LANES; i++)
+            HashX16RStep(nAlgo, buf[i], nLen, buf[i]);
+    }
+}
+
+static void HashAlgo4Way(benchmark::State& state, int nAlgo)
+{
+    X16RTransform4Way transform = X16RGetTransform4Way(nAlgo);
+    if (!transform) {
+        // No multi-buffer support on this CPU, report the scalar speed instead
+        HashAlgoScalar(state, nAlgo, 64);
+        return;
+    }
+
+    uint512 buf[X16R_4WAY_LANES];
+    const unsigned char* in[X16R_4WAY_LANES];
+    unsigned char* out[X16R_4WAY_LANES];
+    for (size_t i = 0; i < X16R_4WAY_LANES; i++) {
+        buf[i] = uint512();
+        *buf[i].begin() = i;
+        in[i] = out[i] = buf[i].begin();
+    }
+    while (state.KeepRunning())
+        transform(out, in, 64);
+}
+
+#define BENCH_X16R_ALGO(nAlgo, name) \
+    static void X16R_##name##_80(benchmark::State& state) { HashAlgoScalar(state, nAlgo, 80); } \
+    static void X16R_##name##_64(benchmark::State& state) { HashAlgoScalar(state, nAlgo, 64); } \
+    BENCHMARK(X16R_##name##_80, 100 * 1000); \
+    BENCHMARK(X16R_##name##_64, 100 * 1000);
+
+#define BENCH_X16R_ALGO_4WAY(nAlgo, name) \
+    BENCH_X16R_ALGO(nAlgo, name) \
+    static void X16R_##name##_64_4way(benchmark::State& state) { HashAlgo4Way(state, nAlgo); } \
+    BENCHMARK(X16R_##name##_64_4way, 100 * 1000);
+
+BENCH_X16R_ALGO_4WAY(0, Blake512)
+BENCH_X16R_ALGO_4WAY(1, Bmw512)
+BENCH_X16R_ALGO(2, Groestl512)
+BENCH_X16R_ALGO(3, Jh512)
+BENCH_X16R_ALGO_4WAY(4, Keccak512)
+BENCH_X16R_ALGO_4WAY(5, Skein512)
+BENCH_X16R_ALGO(6, Luffa512)
+BENCH_X16R_ALGO_4WAY(7, Cubehash512)
+BENCH_X16R_ALGO(8, Shavite512)
+BENCH_X16R_ALGO(9, Simd512)
+BENCH_X16R_ALGO(10, Echo512)
+BENCH_X16R_ALGO(11, Hamsi512)
+BENCH_X16R_ALGO(12, Fugue512)
+BENCH_X16R_ALGO(13, Shabal512)
+BENCH_X16R_ALGO(14, Whirlpool)
+BENCH_X16R_ALGO_4WAY(15, Sha512)
+
+// End to end GetPoWHash over the genesis headers of every network, each hashes in a different algorithm order
+static void X16R_GetPoWHash(benchmark::State& state)
+{
+    std::vector<CBlockHeader> vHeaders;
+    for (const std::string& chain : {CBaseChainParams::MAIN, CBaseChainParams::TESTNET, CBaseChainParams::REGTEST})
+        vHeaders.push_back(CreateChainParams(chain)->GenesisBlock().GetBlockHeader());
+
+    while (state.KeepRunning()) {
+        for (const CBlockHeader& header : vHeaders)
+            header.GetPoWHash();
+    }
+}
+
+// Whole header PoW hashes, X16R_4WAY_LANES nonces of the same header per iteration as the miner does
+static std::vector<CBlockHeader> NonceHeaders()
+{
+    CBlockHeader header;
+    header.nVersion = 1;
+    header.nTime = 1546300800;
+    header.nBits = 0x1e0ffff0;
+    return std::vector<CBlockHeader>(X16R_4WAY_LANES, header);
+}
+
+static void X16R_HeaderScalar(benchmark::State& state)
+{
+    std::vector<CBlockHeader> vHeaders = NonceHeaders();
+    uint32_t nNonce = 0;
+    while (state.KeepRunning()) {
+        for (CBlockHeader& header : vHeaders) {
+            header.nNonce = nNonce++;
+            header.GetPoWHash();
+        }
+    }
+}
+
+static void X16R_HeaderMulti(benchmark::State& state)
+{
+    std::vector<CBlockHeader> vHeaders = NonceHeaders();
+    std::vector<const CBlockHeader*> vpHeaders;
+    for (const CBlockHeader& header : vHeaders)
+        vpHeaders.push_back(&header);
+    std::vector<uint256> vHashes;
+    uint32_t nNonce = 0;
+    while (state.KeepRunning()) {
+        for (CBlockHeader& header : vHeaders)
+            header.nNonce = nNonce++;
+        GetPoWHashes(vpHeaders, vHashes);
+    }
+}
+
+BENCHMARK(X16R_GetPoWHash, 5 * 1000);
+BENCHMARK(X16R_HeaderScalar, 5 * 1000);
+BENCHMARK(X16R_HeaderMulti, 5 * 1000);
@@ -0,0 +1,59 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <chainparams.h>
+#include <libzerocoin/SerialNumberSoK_small.h>
+#include <random.h>
+
+// Creating a proof takes much longer than verifying one, so only a few distinct proofs are made and then repeated.
+// Every proof gets its own random weight in a batch, so repeats cost the same to verify as distinct proofs.
+static const size_t SOK_BENCH_DISTINCT_PROOFS = 4;
+
+static std::vector<libzerocoin::SerialNumberSoKProof> CreateSoKProofs(const libzerocoin::ZerocoinParams* params, size_t nProofs)
+{
+    std::vector<libzerocoin::SerialNumberSoKProof> vProofs;
+    for (size_t i = 0; i < std::min(nProofs, SOK_BENCH_DISTINCT_PROOFS); i++) {
+        libzerocoin::PrivateCoin coin(params, libzerocoin::CoinDenomination::ZQ_TEN);
+        const libzerocoin::Commitment commitment(&params->serialNumberSoKCommitmentGroup, coin.getPublicCoin().getValue());
+        uint256 hashMsg = GetRandHash();
+        libzerocoin::SerialNumberSoK_small sok(params, coin, commitment, hashMsg);
+        vProofs.emplace_back(sok, coin.getSerialNumber(), commitment.getCommitmentValue(), hashMsg);
+    }
+    for (size_t i = vProofs.size(); i < nProofs; i++)
+        vProofs.emplace_back(vProofs[i % SOK_BENCH_DISTINCT_PROOFS]);
+    return vProofs;
+}
+
+// Verifies nProofs serial number signatures of knowledge one at a time, as a block with that many spends did before
+// batching, or all together with BatchVerify
+static void ZerocoinSoKVerify(benchmark::State& state, size_t nProofs, bool fBatch)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    std::vector<libzerocoin::SerialNumberSoKProof> vProofs = CreateSoKProofs(chainParams->Zerocoin_Params(), nProofs);
+
+    while (state.KeepRunning()) {
+        if (fBatch) {
+            assert(libzerocoin::SerialNumberSoKProof::BatchVerify(vProofs));
+        } else {
+            for (const libzerocoin::SerialNumberSoKProof& proof : vProofs)
+                assert(proof.signature.Verify(proof.coinSerialNumber, proof.valueOfCommitmentToCoin, proof.msghash));
+        }
+    }
+}
+
+static void ZerocoinSoKVerify_1(benchmark::State& state) { ZerocoinSoKVerify(state, 1, false); }
+static void ZerocoinSoKVerify_10(benchmark::State& state) { ZerocoinSoKVerify(state, 10, false); }
+static void ZerocoinSoKVerify_100(benchmark::State& state) { ZerocoinSoKVerify(state, 100, false); }
+static void ZerocoinSoKBatchVerify_1(benchmark::State& state) { ZerocoinSoKVerify(state, 1, true); }
+static void ZerocoinSoKBatchVerify_10(benchmark::State& state) { ZerocoinSoKVerify(state, 10, true); }
+static void ZerocoinSoKBatchVerify_100(benchmark::State& state) { ZerocoinSoKVerify(state, 100, true); }
+
+BENCHMARK(ZerocoinSoKVerify_1, 10);
+BENCHMARK(ZerocoinSoKVerify_10, 1);
+BENCHMARK(ZerocoinSoKVerify_100, 1);
+BENCHMARK(ZerocoinSoKBatchVerify_1, 10);
+BENCHMARK(ZerocoinSoKBatchVerify_10, 1);
+BENCHMARK(ZerocoinSoKBatchVerify_100, 1);
@@ -172,9 +172,41 @@ const CBlockIndex* LastCommonAncestor(const CBlockIndex* pa, const CBlockIndex*
     return pa;
 }
 
+void CBlockIndex::SetAccumulatorHashes(const CDenominationArray<uint256>& hashes)
+{
+    if (pprev && pprev->GetAccumulatorHashes() == hashes)
+        pAccumulatorHashes = pprev->pAccumulatorHashes;
+    else if (GetAccumulatorHashes() != hashes)
+        pAccumulatorHashes = std::make_shared<const CDenominationArray<uint256>>(hashes);
+}
+
+void CBlockIndex::SetAccumulatorHashes(const std::map<libzerocoin::CoinDenomination, uint256>& mapHashes)
+{
+    CDenominationArray<uint256> hashes;
+    hashes = mapHashes;
+    SetAccumulatorHashes(hashes);
+}
+
+void CBlockIndex::LoadAccumulatorHashes()
+{
+    if (pprev && (nStatus & BLOCK_INHERIT_CHECKPOINTS))
+        pAccumulatorHashes = pprev->pAccumulatorHashes;
+    else
+        SetAccumulatorHashes(GetAccumulatorHashes());
+    nStatus &= ~BLOCK_INHERIT_CHECKPOINTS;
+}
+
+std::shared_ptr<const CDenominationArray<uint256>> CBlockIndex::NullAccumulatorHashes()
+{
+    static const std::shared_ptr<const CDenominationArray<uint256>> pNull = std::make_shared<const CDenominationArray<uint256>>();
+    return pNull;
+}
+
 void CBlockIndex::AddAccumulator(libzerocoin::CoinDenomination denom, CBigNum bnAccumulator)
 {
-    mapAccumulatorHashes[denom] = SerializeHash(bnAccumulator);
+    CDenominationArray<uint256> hashes = GetAccumulatorHashes();
+    hashes[denom] = SerializeHash(bnAccumulator);
+    SetAccumulatorHashes(hashes);
 }
 
 void CBlockIndex::AddAccumulator(AccumulatorMap mapAccumulator)
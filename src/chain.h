@@ -14,6 +14,8 @@
 #include <uint256.h>
 #include <libzerocoin/bignum.h>
 
+#include <array>
+#include <memory>
 #include <vector>
 #include <map>
 
@@ -163,6 +165,119 @@ enum BlockStatus: uint32_t {
     BLOCK_FAILED_MASK        =   BLOCK_FAILED_VALID | BLOCK_FAILED_CHILD,
 
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
+
+    BLOCK_HAVE_POWHASH      =   256, //!< hashPoW holds the proof of work hash of the header
+
+    BLOCK_INHERIT_CHECKPOINTS =  512, //!< (disk only) accumulator checkpoints are the same as pprev's and are not stored
+};
+
+/**
+ * A value for each zerocoin denomination, stored inline in the order of libzerocoin::zerocoinDenomList. Block index
+ * entries use this instead of std::map so that they need no heap nodes, and it serializes exactly like a
+ * std::map<CoinDenomination, T> that holds every denomination.
+ */
+template <typename T>
+class CDenominationArray
+{
+public:
+    //! The size of zerocoinDenomList
+    static const size_t SIZE = 4;
+
+    CDenominationArray()
+    {
+        values.fill(T());
+    }
+
+    CDenominationArray& operator=(const std::map<libzerocoin::CoinDenomination, T>& mapValues)
+    {
+        values.fill(T());
+        for (const auto& it : mapValues) {
+            int i = Index(it.first);
+            if (i >= 0)
+                values[i] = it.second;
+        }
+        return *this;
+    }
+
+    /** Whether mapValues has exactly the denominations of zerocoinDenomList as keys, so it converts without loss */
+    static bool IsCanonical(const std::map<libzerocoin::CoinDenomination, T>& mapValues)
+    {
+        if (mapValues.size() != SIZE)
+            return false;
+        for (const auto& it : mapValues) {
+            if (Index(it.first) < 0)
+                return false;
+        }
+        return true;
+    }
+
+    /** Position of denom in zerocoinDenomList, or -1 if it is not a denomination */
+    static int Index(libzerocoin::CoinDenomination denom)
+    {
+        for (size_t i = 0; i < SIZE; i++) {
+            if (libzerocoin::zerocoinDenomList[i] == denom)
+                return i;
+        }
+        return -1;
+    }
+
+    T& operator[](libzerocoin::CoinDenomination denom)
+    {
+        int i = Index(denom);
+        if (i < 0)
+            throw std::out_of_range("CDenominationArray: invalid denomination");
+        return values[i];
+    }
+
+    T& at(libzerocoin::CoinDenomination denom)
+    {
+        return (*this)[denom];
+    }
+
+    const T& at(libzerocoin::CoinDenomination denom) const
+    {
+        int i = Index(denom);
+        if (i < 0)
+            throw std::out_of_range("CDenominationArray: invalid denomination");
+        return values[i];
+    }
+
+    /** The value for denom, or a default value for something that is not a denomination */
+    T Get(libzerocoin::CoinDenomination denom) const
+    {
+        int i = Index(denom);
+        return i < 0 ? T() : values[i];
+    }
+
+    std::map<libzerocoin::CoinDenomination, T> ToMap() const
+    {
+        std::map<libzerocoin::CoinDenomination, T> mapValues;
+        for (size_t i = 0; i < SIZE; i++)
+            mapValues.emplace(libzerocoin::zerocoinDenomList[i], values[i]);
+        return mapValues;
+    }
+
+    bool operator==(const CDenominationArray& other) const { return values == other.values; }
+    bool operator!=(const CDenominationArray& other) const { return values != other.values; }
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        WriteCompactSize(s, SIZE);
+        for (size_t i = 0; i < SIZE; i++)
+            s << libzerocoin::zerocoinDenomList[i] << values[i];
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        std::map<libzerocoin::CoinDenomination, T> mapValues;
+        s >> mapValues;
+        *this = mapValues;
+    }
+
+private:
+    std::array<T, SIZE> values;
 };
 
 /** The block chain is a tree shaped structure starting with the
@@ -234,19 +349,24 @@ public:
     int32_t nSequenceId;
 
     //! zerocoin specific fields
-    std::map<libzerocoin::CoinDenomination, int64_t> mapZerocoinSupply;
-    std::vector<libzerocoin::CoinDenomination> vMintDenominationsInBlock;
+    CDenominationArray<int64_t> mapZerocoinSupply;
+    //! Number of mints of each denomination in this block
+    CDenominationArray<uint32_t> mapMintCounts;
 
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
 
-    //! Hash value for the accumulator. Can be used to access the zerocoindb for the accumulator value
-    std::map<libzerocoin::CoinDenomination ,uint256> mapAccumulatorHashes;
+    //! Hash value for the accumulator. Can be used to access the zerocoindb for the accumulator value. Checkpoints only
+    //! change every ten blocks, so entries with the same checkpoints as pprev share its copy.
+    std::shared_ptr<const CDenominationArray<uint256>> pAccumulatorHashes;
 
     uint256 hashMerkleRoot;
     uint256 hashWitnessMerkleRoot;
     uint256 hashPoFN;
 
+    //! X16R hash of the header, set when nStatus has BLOCK_HAVE_POWHASH so reindex and verifychain can skip rehashing
+    uint256 hashPoW;
+
     void SetNull()
     {
         phashBlock = nullptr;
@@ -275,20 +395,15 @@ public:
 
         nAnonOutputs = 0;
 
-        mapAccumulatorHashes.clear();
+        pAccumulatorHashes = NullAccumulatorHashes();
         hashMerkleRoot = uint256();
         hashWitnessMerkleRoot = uint256();
 
-        for (auto& denom : libzerocoin::zerocoinDenomList) {
-            mapAccumulatorHashes[denom] = uint256();
-        }
-
         // Start supply of each denomination with 0s
-        for (auto& denom : libzerocoin::zerocoinDenomList) {
-            mapZerocoinSupply.insert(std::make_pair(denom, 0));
-        }
+        mapZerocoinSupply = CDenominationArray<int64_t>();
 
-        vMintDenominationsInBlock.clear();
+        mapMintCounts = CDenominationArray<uint32_t>();
+        hashPoW = uint256();
 
         nVersion       = 0;
         hashVeilData   = uint256();
@@ -356,9 +471,17 @@ public:
 
     uint256 GetBlockPoWHash() const
     {
+        if (nStatus & BLOCK_HAVE_POWHASH)
+            return hashPoW;
         return GetBlockHeader().GetPoWHash();
     }
 
+    void SetBlockPoWHash(const uint256& hash)
+    {
+        hashPoW = hash;
+        nStatus |= BLOCK_HAVE_POWHASH;
+    }
+
     int64_t GetBlockTime() const
     {
         return (int64_t)nTime;
@@ -372,14 +495,25 @@ public:
     /** Returns the hash of the accumulator for the specified denomination. If it doesn't exist then a new uint256 is returned*/
     uint256 GetAccumulatorHash(libzerocoin::CoinDenomination denom) const
     {
-        if(mapAccumulatorHashes.find(denom) != mapAccumulatorHashes.end()) {
-            return mapAccumulatorHashes.find(denom)->second;
-        }
-        else {
-            return uint256();
-        }
+        return pAccumulatorHashes->Get(denom);
     }
 
+    const CDenominationArray<uint256>& GetAccumulatorHashes() const
+    {
+        return *pAccumulatorHashes;
+    }
+
+    //! Sets the accumulator checkpoints, sharing the copy held by pprev when they are the same
+    void SetAccumulatorHashes(const CDenominationArray<uint256>& hashes);
+    void SetAccumulatorHashes(const std::map<libzerocoin::CoinDenomination, uint256>& mapHashes);
+
+    //! Called for each entry in height order when loading the block index. Takes the checkpoints of pprev if they were
+    //! not stored, and shares its copy if they are the same.
+    void LoadAccumulatorHashes();
+
+    //! The checkpoints of entries that have none yet, shared by all of them
+    static std::shared_ptr<const CDenominationArray<uint256>> NullAccumulatorHashes();
+
     static constexpr int nMedianTimeSpan = 11;
 
     int64_t GetMedianTimePast() const
@@ -423,8 +557,30 @@ public:
 
     bool MintedDenomination(libzerocoin::CoinDenomination denom) const
     {
-        return std::find(vMintDenominationsInBlock.begin(), vMintDenominationsInBlock.end(), denom)
-                        != vMintDenominationsInBlock.end();
+        return GetMintCount(denom) > 0;
+    }
+
+    uint32_t GetMintCount(libzerocoin::CoinDenomination denom) const
+    {
+        return mapMintCounts.Get(denom);
+    }
+
+    /** The denomination of every mint in this block, grouped by denomination */
+    std::vector<libzerocoin::CoinDenomination> GetMintDenominations() const
+    {
+        std::vector<libzerocoin::CoinDenomination> vDenoms;
+        for (auto& denom : libzerocoin::zerocoinDenomList)
+            vDenoms.insert(vDenoms.end(), mapMintCounts.at(denom), denom);
+        return vDenoms;
+    }
+
+    void SetMintDenominations(const std::vector<libzerocoin::CoinDenomination>& vDenoms)
+    {
+        mapMintCounts = CDenominationArray<uint32_t>();
+        for (auto& denom : vDenoms) {
+            if (CDenominationArray<uint32_t>::Index(denom) >= 0)
+                mapMintCounts[denom]++;
+        }
     }
 
     std::string ToString() const
@@ -492,6 +648,12 @@ public:
 
     explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex) {
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
+
+        // Once both blocks are connected the checkpoints can no longer change, so they are only stored where they do
+        nStatus &= ~BLOCK_INHERIT_CHECKPOINTS;
+        if (pprev && IsValid(BLOCK_VALID_SCRIPTS) && pprev->IsValid(BLOCK_VALID_SCRIPTS) &&
+                pprev->GetAccumulatorHashes() == GetAccumulatorHashes())
+            nStatus |= BLOCK_INHERIT_CHECKPOINTS;
     }
 
     ADD_SERIALIZE_METHODS;
@@ -525,9 +687,24 @@ public:
         READWRITE(nTime);
         READWRITE(nBits);
         READWRITE(nNonce);
-        READWRITE(mapAccumulatorHashes);
+        // Inherited checkpoints are filled in from pprev by LoadBlockIndex
+        if (!(nStatus & BLOCK_INHERIT_CHECKPOINTS)) {
+            CDenominationArray<uint256> mapAccumulatorHashes;
+            if (!ser_action.ForRead())
+                mapAccumulatorHashes = GetAccumulatorHashes();
+            READWRITE(mapAccumulatorHashes);
+            if (ser_action.ForRead())
+                SetAccumulatorHashes(mapAccumulatorHashes);
+        }
         READWRITE(mapZerocoinSupply);
+
+        // Kept in memory as a count per denomination, stored as the list of mint denominations
+        std::vector<libzerocoin::CoinDenomination> vMintDenominationsInBlock;
+        if (!ser_action.ForRead())
+            vMintDenominationsInBlock = GetMintDenominations();
         READWRITE(vMintDenominationsInBlock);
+        if (ser_action.ForRead())
+            SetMintDenominations(vMintDenominationsInBlock);
         READWRITE(fProofOfFullNode);
 
         //Proof of stake
@@ -535,6 +712,25 @@ public:
 
         //Ring CT
         READWRITE(nAnonOutputs);
+
+        if (nStatus & BLOCK_HAVE_POWHASH)
+            SerializePoWHash(s, ser_action);
+    }
+
+    template <typename Stream>
+    void SerializePoWHash(Stream& s, CSerActionSerialize)
+    {
+        s << hashPoW;
+    }
+
+    // Versions without hashPoW keep the unknown status bit when they rewrite an entry, but drop the hash after it
+    template <typename Stream>
+    void SerializePoWHash(Stream& s, CSerActionUnserialize)
+    {
+        if (s.empty())
+            nStatus &= ~BLOCK_HAVE_POWHASH;
+        else
+            s >> hashPoW;
     }
 
     uint256 GetBlockHash() const
@@ -24,6 +24,12 @@
 #include <tinyformat.h>
 #include <libzerocoin/CoinSpend.h>
 #include <veil/zerocoin/zchain.h>
+#include <cuckoocache.h>
+#include <crypto/sha256.h>
+#include <random.h>
+#include <script/sigcache.h>
+
+#include <boost/thread.hpp>
 
 bool IsFinalTx(const CTransaction &tx, int nBlockHeight, int64_t nBlockTime)
 {
@@ -269,7 +275,78 @@ bool CheckStandardOutput(CValidationState &state, const Consensus::Params& conse
     return CheckValue(state, p->nValue, nValueOut);
 }
 
-bool CheckBlindOutput(CValidationState &state, const CTxOutCT *p)
+namespace {
+/**
+ * Valid range proof cache, to avoid verifying the range proofs of blinded outputs
+ * twice (once when accepted into memory pool, and again when accepted into the block chain)
+ */
+class CRangeProofCache
+{
+private:
+    //! Entries are SHA256(nonce || commitment || range proof)
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_rangeproofcache;
+
+public:
+    CRangeProofCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    void ComputeEntry(uint256& entry, const secp256k1_pedersen_commitment& commitment, const std::vector<uint8_t>& vRangeproof)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(commitment.data, 33).Write(vRangeproof.data(), vRangeproof.size()).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry, const bool erase)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_rangeproofcache);
+        return setValid.contains(entry, erase);
+    }
+
+    void Set(uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_rangeproofcache);
+        setValid.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        return setValid.setup_bytes(n);
+    }
+};
+
+static CRangeProofCache rangeProofCache;
+} // namespace
+
+void InitRangeProofCache()
+{
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxrangeproofcachesize", DEFAULT_MAX_RANGEPROOF_CACHE_SIZE)), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = rangeProofCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for range proof cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+bool CRangeProofCheck::operator()()
+{
+    uint256 entry;
+    rangeProofCache.ComputeEntry(entry, *pcommitment, *pvRangeproof);
+    if (rangeProofCache.Get(entry, !cacheStore))
+        return true;
+
+    uint64_t min_value, max_value;
+    if (secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value, pcommitment, pvRangeproof->data(),
+            pvRangeproof->size(), nullptr, 0, secp256k1_generator_h) != 1)
+        return false;
+
+    if (cacheStore)
+        rangeProofCache.Set(entry);
+    return true;
+}
+
+bool CheckBlindOutput(CValidationState &state, const CTxOutCT *p, std::vector<CRangeProofCheck> *pvChecks, bool cacheStore)
 {
     if (p->vData.size() < 33 || p->vData.size() > 33 + 5)
         return state.DoS(100, false, REJECT_INVALID, "bad-ctout-ephem-size");
@@ -282,17 +359,18 @@ bool CheckBlindOutput(CValidationState &state, const CTxOutCT *p)
     if (/*todo: fBusyImporting && */ fSkipRangeproof)
         return true;
 
-    uint64_t min_value, max_value;
-    int rv = secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value, &p->commitment, p->vRangeproof.data(),
-            p->vRangeproof.size(), nullptr, 0, secp256k1_generator_h);
-
-    if (rv != 1)
-        return state.DoS(100, false, REJECT_INVALID, "bad-ctout-rangeproof-verify");
+    CRangeProofCheck check(&p->commitment, &p->vRangeproof, "bad-ctout-rangeproof-verify", cacheStore);
+    if (pvChecks) {
+        pvChecks->push_back(CRangeProofCheck());
+        check.swap(pvChecks->back());
+    } else if (!check()) {
+        return state.DoS(100, false, REJECT_INVALID, check.GetRejectReason());
+    }
 
     return true;
 }
 
-bool CheckAnonOutput(CValidationState &state, const CTxOutRingCT *p)
+bool CheckAnonOutput(CValidationState &state, const CTxOutRingCT *p, std::vector<CRangeProofCheck> *pvChecks, bool cacheStore)
 {
     if (p->vData.size() < 33 || p->vData.size() > 33 + 5)
         return state.DoS(100, false, REJECT_INVALID, "bad-rctout-ephem-size");
@@ -304,12 +382,13 @@ bool CheckAnonOutput(CValidationState &state, const CTxOutRingCT *p)
     if (/* todo: fBusyImporting && */ fSkipRangeproof)
         return true;
 
-    uint64_t min_value, max_value;
-    int rv = secp256k1_rangeproof_verify(secp256k1_ctx_blind, &min_value, &max_value, &p->commitment, p->vRangeproof.data(),
-            p->vRangeproof.size(), nullptr, 0, secp256k1_generator_h);
-
-    if (rv != 1)
-        return state.DoS(100, false, REJECT_INVALID, "bad-rctout-rangeproof-verify");
+    CRangeProofCheck check(&p->commitment, &p->vRangeproof, "bad-rctout-rangeproof-verify", cacheStore);
+    if (pvChecks) {
+        pvChecks->push_back(CRangeProofCheck());
+        check.swap(pvChecks->back());
+    } else if (!check()) {
+        return state.DoS(100, false, REJECT_INVALID, check.GetRejectReason());
+    }
 
     return true;
 }
@@ -326,7 +405,8 @@ bool CheckDataOutput(CValidationState &state, const CTxOutData *p)
     return true;
 }
 
-bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fCheckDuplicateInputs)
+bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fCheckDuplicateInputs,
+        std::vector<CRangeProofCheck> *pvRangeProofChecks, bool cacheRangeProofStore)
 {
     // Basic checks that don't depend on any context
     if (tx.vin.empty())
@@ -367,12 +447,12 @@ bool CheckTransaction(const CTransaction& tx, CValidationState &state, bool fChe
                 break;
             }
             case OUTPUT_CT:
-                if (!CheckBlindOutput(state, (CTxOutCT*) txout.get()))
+                if (!CheckBlindOutput(state, (CTxOutCT*) txout.get(), pvRangeProofChecks, cacheRangeProofStore))
                     return false;
                 nCTOut++;
                 break;
             case OUTPUT_RINGCT:
-                if (!CheckAnonOutput(state, (CTxOutRingCT*) txout.get()))
+                if (!CheckAnonOutput(state, (CTxOutRingCT*) txout.get(), pvRangeProofChecks, cacheRangeProofStore))
                     return false;
                 nRingCTOut++;
                 break;
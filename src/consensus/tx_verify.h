@@ -7,6 +7,8 @@
 
 #include <amount.h>
 
+#include <secp256k1_rangeproof.h>
+
 #include <stdint.h>
 #include <vector>
 
@@ -17,10 +19,52 @@ class CTransaction;
 class CTxOut;
 class CValidationState;
 
+/** Default for -maxrangeproofcachesize, size of the valid range proof cache in MiB */
+static const unsigned int DEFAULT_MAX_RANGEPROOF_CACHE_SIZE = 8;
+
+/**
+ * Closure representing the verification of a single CT or RingCT output's range proof.
+ * Proofs that verified once are remembered in the range proof cache, if cacheStore is false
+ * a cache hit also removes the entry. strRejectReason is what the output type reports when the proof is invalid.
+ */
+class CRangeProofCheck
+{
+private:
+    const secp256k1_pedersen_commitment *pcommitment;
+    const std::vector<uint8_t> *pvRangeproof;
+    bool cacheStore;
+    const char *strRejectReason;
+
+public:
+    CRangeProofCheck(): pcommitment(nullptr), pvRangeproof(nullptr), cacheStore(false), strRejectReason("") {}
+    CRangeProofCheck(const secp256k1_pedersen_commitment *pcommitmentIn, const std::vector<uint8_t> *pvRangeproofIn,
+            const char *strRejectReasonIn, bool cacheIn = true) :
+        pcommitment(pcommitmentIn), pvRangeproof(pvRangeproofIn), cacheStore(cacheIn), strRejectReason(strRejectReasonIn) {}
+
+    bool operator()();
+
+    const char *GetRejectReason() const { return strRejectReason; }
+
+    void swap(CRangeProofCheck &check) {
+        std::swap(pcommitment, check.pcommitment);
+        std::swap(pvRangeproof, check.pvRangeproof);
+        std::swap(cacheStore, check.cacheStore);
+        std::swap(strRejectReason, check.strRejectReason);
+    }
+};
+
+/** Initializes the valid range proof cache */
+void InitRangeProofCache();
+
 /** Transaction validation functions */
 
-/** Context-independent validity checks */
-bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fCheckDuplicateInputs=true);
+/**
+ * Context-independent validity checks.
+ * If pvRangeProofChecks is not nullptr, range proof checks are pushed onto it instead of being performed inline.
+ * Setting cacheRangeProofStore to false removes range proofs found in the cache instead of adding new ones.
+ */
+bool CheckTransaction(const CTransaction& tx, CValidationState& state, bool fCheckDuplicateInputs=true,
+        std::vector<CRangeProofCheck> *pvRangeProofChecks=nullptr, bool cacheRangeProofStore=true);
 bool CheckZerocoinMint(const CTxOut& txout, CBigNum& bnValue, CValidationState& state);
 bool CheckZerocoinSpend(const CTransaction& tx, CValidationState& state);
 
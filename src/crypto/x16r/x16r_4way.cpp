@@ -0,0 +1,83 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/x16r/x16r_4way.h>
+
+#include <stdint.h>
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+namespace x16r_avx2
+{
+void Blake512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Bmw512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Keccak512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Skein512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Cubehash512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Sha512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+}
+
+namespace
+{
+// Indexed by the X16R hash selection, see GetHashSelection in hash.h
+X16RTransform4Way Transform4Way[16] = {};
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__)) && defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+void inline cpuid(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d)
+{
+#ifdef __GNUC__
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+#else
+  __asm__ ("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "0"(leaf), "2"(subleaf));
+#endif
+}
+
+/** Check whether the OS has enabled AVX registers. */
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+} // namespace
+
+std::string X16RAutoDetect()
+{
+    std::string ret = "standard";
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__)) && defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, eax, ebx, ecx, edx);
+    bool have_sse4 = (ecx >> 19) & 1;
+    bool have_xsave = (ecx >> 27) & 1;
+    bool have_avx = (ecx >> 28) & 1;
+    bool enabled_avx = have_xsave && have_avx && AVXEnabled();
+    bool have_avx2 = false;
+    if (have_sse4) {
+        cpuid(7, 0, eax, ebx, ecx, edx);
+        have_avx2 = (ebx >> 5) & 1;
+    }
+
+    if (have_avx2 && enabled_avx) {
+        Transform4Way[0] = x16r_avx2::Blake512_4way;
+        Transform4Way[1] = x16r_avx2::Bmw512_4way;
+        Transform4Way[4] = x16r_avx2::Keccak512_4way;
+        Transform4Way[5] = x16r_avx2::Skein512_4way;
+        Transform4Way[7] = x16r_avx2::Cubehash512_4way;
+        Transform4Way[15] = x16r_avx2::Sha512_4way;
+        ret = "avx2(4way)";
+    }
+#endif
+
+    return ret;
+}
+
+X16RTransform4Way X16RGetTransform4Way(int nAlgo)
+{
+    if (nAlgo < 0 || nAlgo >= 16)
+        return nullptr;
+    return Transform4Way[nAlgo];
+}
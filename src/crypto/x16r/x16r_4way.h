@@ -0,0 +1,23 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_X16R_X16R_4WAY_H
+#define BITCOIN_CRYPTO_X16R_X16R_4WAY_H
+
+#include <stdlib.h>
+#include <string>
+
+/** Number of messages a multi-buffer X16R primitive hashes at once. */
+static const size_t X16R_4WAY_LANES = 4;
+
+/** Hash X16R_4WAY_LANES messages of len bytes each into as many 64 byte digests. */
+typedef void (*X16RTransform4Way)(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+
+/** Autodetect the best available multi-buffer X16R primitives. Returns the name of the implementation. */
+std::string X16RAutoDetect();
+
+/** Return the multi-buffer version of X16R algorithm nAlgo (0-15), or nullptr if it only runs one message at a time. */
+X16RTransform4Way X16RGetTransform4Way(int nAlgo);
+
+#endif // BITCOIN_CRYPTO_X16R_X16R_4WAY_H
@@ -0,0 +1,750 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Multi-buffer versions of the X16R primitives that are built from word-wise
+// additions, rotations and logic only: blake512, bmw512, keccak512, skein512,
+// sha512 and cubehash512. Every function hashes four equally long messages at
+// once, one message per vector lane.
+//
+// This file is included by the instruction set specific translation units
+// (currently only x16r_avx2.cpp), which compile the same code with their own
+// target flags. Everything here must therefore have internal linkage. Without
+// 256-bit registers the lanes gain nothing over the scalar sph code.
+
+#ifndef BITCOIN_CRYPTO_X16R_X16R_4WAY_IMPL_H
+#define BITCOIN_CRYPTO_X16R_X16R_4WAY_IMPL_H
+
+#include <crypto/common.h>
+
+#include <stdint.h>
+#include <string.h>
+
+namespace {
+
+typedef uint64_t v4u64 __attribute__((vector_size(32)));
+typedef uint32_t v4u32 __attribute__((vector_size(16)));
+
+inline v4u64 Splat(uint64_t x) { return v4u64{x, x, x, x}; }
+inline v4u64 RotL(v4u64 x, int n) { return (x << n) | (x >> (64 - n)); }
+inline v4u64 RotR(v4u64 x, int n) { return (x >> n) | (x << (64 - n)); }
+
+inline v4u32 RotL32(v4u32 x, int n) { return (x << n) | (x >> (32 - n)); }
+
+/** Call f(0) ... f(N - 1) with constant arguments, so that arrays indexed by them can live in registers. */
+template <int N>
+struct Unroll
+{
+    template <typename F>
+    static inline void __attribute__((always_inline)) Run(const F& f)
+    {
+        Unroll<N - 1>::Run(f);
+        f(N - 1);
+    }
+};
+
+template <>
+struct Unroll<0>
+{
+    template <typename F>
+    static inline void __attribute__((always_inline)) Run(const F&) {}
+};
+
+inline v4u64 LoadLE(const unsigned char* const in[4], size_t offset)
+{
+    return v4u64{ReadLE64(in[0] + offset), ReadLE64(in[1] + offset), ReadLE64(in[2] + offset), ReadLE64(in[3] + offset)};
+}
+
+inline v4u64 LoadBE(const unsigned char* const in[4], size_t offset)
+{
+    return v4u64{ReadBE64(in[0] + offset), ReadBE64(in[1] + offset), ReadBE64(in[2] + offset), ReadBE64(in[3] + offset)};
+}
+
+inline v4u32 LoadLE32(const unsigned char* const in[4], size_t offset)
+{
+    return v4u32{ReadLE32(in[0] + offset), ReadLE32(in[1] + offset), ReadLE32(in[2] + offset), ReadLE32(in[3] + offset)};
+}
+
+inline void StoreLE32(unsigned char* const out[4], size_t offset, v4u32 v)
+{
+    WriteLE32(out[0] + offset, v[0]);
+    WriteLE32(out[1] + offset, v[1]);
+    WriteLE32(out[2] + offset, v[2]);
+    WriteLE32(out[3] + offset, v[3]);
+}
+
+inline void StoreLE(unsigned char* const out[4], size_t offset, v4u64 v)
+{
+    WriteLE64(out[0] + offset, v[0]);
+    WriteLE64(out[1] + offset, v[1]);
+    WriteLE64(out[2] + offset, v[2]);
+    WriteLE64(out[3] + offset, v[3]);
+}
+
+inline void StoreBE(unsigned char* const out[4], size_t offset, v4u64 v)
+{
+    WriteBE64(out[0] + offset, v[0]);
+    WriteBE64(out[1] + offset, v[1]);
+    WriteBE64(out[2] + offset, v[2]);
+    WriteBE64(out[3] + offset, v[3]);
+}
+
+/** Room for the last (partial) message block of each lane plus one block of padding. */
+struct TailBuffer
+{
+    unsigned char data[4][256];
+    const unsigned char* block[4];
+
+    /** Copy the last nRemain bytes of every message and point the lanes at block nBlock of the copy. */
+    TailBuffer(const unsigned char* const in[4], size_t len, size_t nRemain)
+    {
+        memset(data, 0, sizeof(data));
+        for (int i = 0; i < 4; i++) {
+            if (nRemain)
+                memcpy(data[i], in[i] + len - nRemain, nRemain);
+        }
+        Select(0);
+    }
+
+    void Select(size_t nBlockOffset)
+    {
+        for (int i = 0; i < 4; i++)
+            block[i] = data[i] + nBlockOffset;
+    }
+
+    void SetByte(size_t pos, unsigned char c)
+    {
+        for (int i = 0; i < 4; i++)
+            data[i][pos] |= c;
+    }
+
+    void SetLE64(size_t pos, uint64_t x)
+    {
+        for (int i = 0; i < 4; i++)
+            WriteLE64(data[i] + pos, x);
+    }
+
+    void SetBE64(size_t pos, uint64_t x)
+    {
+        for (int i = 0; i < 4; i++)
+            WriteBE64(data[i] + pos, x);
+    }
+};
+
+inline void Advance(const unsigned char* const in[4], const unsigned char* block[4], size_t offset)
+{
+    for (int i = 0; i < 4; i++)
+        block[i] = in[i] + offset;
+}
+
+////// BLAKE-512
+
+const uint64_t BLAKE512_IV[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+const uint64_t BLAKE512_C[16] = {
+    0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL,
+    0x452821E638D01377ULL, 0xBE5466CF34E90C6CULL, 0xC0AC29B7C97C50DDULL, 0x3F84D5B5B5470917ULL,
+    0x9216D5D98979FB1BULL, 0xD1310BA698DFB5ACULL, 0x2FFD72DBD01ADFB7ULL, 0xB8E1AFED6A267E96ULL,
+    0xBA7C9045F12C7F99ULL, 0x24A19947B3916CF7ULL, 0x0801F2E2858EFC16ULL, 0x636920D871574E69ULL
+};
+
+const unsigned char BLAKE512_SIGMA[10][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+    {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+    { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+    { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+    { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+    {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+    {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+    { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+    {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0}
+};
+
+inline void __attribute__((always_inline)) BlakeG(v4u64 v[16], const v4u64 m[16], const unsigned char* s, int a, int b, int c, int d)
+{
+    v[a] += v[b] + (m[s[0]] ^ Splat(BLAKE512_C[s[1]]));
+    v[d] = RotR(v[d] ^ v[a], 32);
+    v[c] += v[d];
+    v[b] = RotR(v[b] ^ v[c], 25);
+    v[a] += v[b] + (m[s[1]] ^ Splat(BLAKE512_C[s[0]]));
+    v[d] = RotR(v[d] ^ v[a], 16);
+    v[c] += v[d];
+    v[b] = RotR(v[b] ^ v[c], 11);
+}
+
+/** Compress one block per lane. nBits is the message bit counter, 0 for a block of padding only. */
+void Blake512Compress(v4u64 h[8], const unsigned char* const block[4], uint64_t nBits)
+{
+    v4u64 m[16], v[16];
+    for (int i = 0; i < 16; i++)
+        m[i] = LoadBE(block, 8 * i);
+    for (int i = 0; i < 8; i++)
+        v[i] = h[i];
+    for (int i = 0; i < 4; i++)
+        v[8 + i] = Splat(BLAKE512_C[i]);
+    v[12] = Splat(nBits ^ BLAKE512_C[4]);
+    v[13] = Splat(nBits ^ BLAKE512_C[5]);
+    v[14] = Splat(BLAKE512_C[6]);
+    v[15] = Splat(BLAKE512_C[7]);
+    Unroll<16>::Run([&](int r) {
+        const unsigned char* s = BLAKE512_SIGMA[r % 10];
+        BlakeG(v, m, s + 0, 0, 4, 8, 12);
+        BlakeG(v, m, s + 2, 1, 5, 9, 13);
+        BlakeG(v, m, s + 4, 2, 6, 10, 14);
+        BlakeG(v, m, s + 6, 3, 7, 11, 15);
+        BlakeG(v, m, s + 8, 0, 5, 10, 15);
+        BlakeG(v, m, s + 10, 1, 6, 11, 12);
+        BlakeG(v, m, s + 12, 2, 7, 8, 13);
+        BlakeG(v, m, s + 14, 3, 4, 9, 14);
+    });
+    for (int i = 0; i < 8; i++)
+        h[i] ^= v[i] ^ v[i + 8];
+}
+
+void Blake512(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    v4u64 h[8];
+    for (int i = 0; i < 8; i++)
+        h[i] = Splat(BLAKE512_IV[i]);
+
+    const unsigned char* block[4];
+    size_t nBlocks = len / 128;
+    for (size_t b = 0; b < nBlocks; b++) {
+        Advance(in, block, 128 * b);
+        Blake512Compress(h, block, (b + 1) * 1024);
+    }
+
+    // The padding block only counts message bits if it holds any
+    size_t nRemain = len - 128 * nBlocks;
+    size_t nTail = nRemain <= 111 ? 128 : 256;
+    TailBuffer tail(in, len, nRemain);
+    tail.SetByte(nRemain, 0x80);
+    tail.SetByte(nTail - 17, 0x01);
+    tail.SetBE64(nTail - 8, (uint64_t)len << 3);
+    Blake512Compress(h, tail.block, nRemain ? (uint64_t)len << 3 : 0);
+    if (nTail == 256) {
+        tail.Select(128);
+        Blake512Compress(h, tail.block, 0);
+    }
+
+    for (int i = 0; i < 8; i++)
+        StoreBE(out, 8 * i, h[i]);
+}
+
+////// BMW-512
+
+const uint64_t BMW512_IV[16] = {
+    0x8081828384858687ULL, 0x88898A8B8C8D8E8FULL, 0x9091929394959697ULL, 0x98999A9B9C9D9E9FULL,
+    0xA0A1A2A3A4A5A6A7ULL, 0xA8A9AAABACADAEAFULL, 0xB0B1B2B3B4B5B6B7ULL, 0xB8B9BABBBCBDBEBFULL,
+    0xC0C1C2C3C4C5C6C7ULL, 0xC8C9CACBCCCDCECFULL, 0xD0D1D2D3D4D5D6D7ULL, 0xD8D9DADBDCDDDEDFULL,
+    0xE0E1E2E3E4E5E6E7ULL, 0xE8E9EAEBECEDEEEFULL, 0xF0F1F2F3F4F5F6F7ULL, 0xF8F9FAFBFCFDFEFFULL
+};
+
+const uint64_t BMW512_FINAL[16] = {
+    0xaaaaaaaaaaaaaaa0ULL, 0xaaaaaaaaaaaaaaa1ULL, 0xaaaaaaaaaaaaaaa2ULL, 0xaaaaaaaaaaaaaaa3ULL,
+    0xaaaaaaaaaaaaaaa4ULL, 0xaaaaaaaaaaaaaaa5ULL, 0xaaaaaaaaaaaaaaa6ULL, 0xaaaaaaaaaaaaaaa7ULL,
+    0xaaaaaaaaaaaaaaa8ULL, 0xaaaaaaaaaaaaaaa9ULL, 0xaaaaaaaaaaaaaaaaULL, 0xaaaaaaaaaaaaaaabULL,
+    0xaaaaaaaaaaaaaaacULL, 0xaaaaaaaaaaaaaaadULL, 0xaaaaaaaaaaaaaaaeULL, 0xaaaaaaaaaaaaaaafULL
+};
+
+inline v4u64 BmwS0(v4u64 x) { return (x >> 1) ^ (x << 3) ^ RotL(x, 4) ^ RotL(x, 37); }
+inline v4u64 BmwS1(v4u64 x) { return (x >> 1) ^ (x << 2) ^ RotL(x, 13) ^ RotL(x, 43); }
+inline v4u64 BmwS2(v4u64 x) { return (x >> 2) ^ (x << 1) ^ RotL(x, 19) ^ RotL(x, 53); }
+inline v4u64 BmwS3(v4u64 x) { return (x >> 2) ^ (x << 2) ^ RotL(x, 28) ^ RotL(x, 59); }
+inline v4u64 BmwS4(v4u64 x) { return (x >> 1) ^ x; }
+inline v4u64 BmwS5(v4u64 x) { return (x >> 2) ^ x; }
+
+inline v4u64 BmwS(int i, v4u64 x)
+{
+    switch (i) {
+    case 0: return BmwS0(x);
+    case 1: return BmwS1(x);
+    case 2: return BmwS2(x);
+    case 3: return BmwS3(x);
+    default: return BmwS4(x);
+    }
+}
+
+/** Message and chaining value term shared by both expansion functions. */
+inline v4u64 BmwAddElement(const v4u64 m[16], const v4u64 h[16], int j)
+{
+    int j0 = j & 15, j3 = (j + 3) & 15, j10 = (j + 10) & 15;
+    return (RotL(m[j0], j0 + 1) + RotL(m[j3], j3 + 1) - RotL(m[j10], j10 + 1) + Splat((uint64_t)(j + 16) * 0x0555555555555555ULL)) ^ h[(j + 7) & 15];
+}
+
+void Bmw512Compress(const v4u64 m[16], const v4u64 h[16], v4u64 dh[16])
+{
+    v4u64 x[16], w[16], q[32];
+    for (int i = 0; i < 16; i++)
+        x[i] = m[i] ^ h[i];
+
+    w[0] = x[5] - x[7] + x[10] + x[13] + x[14];
+    w[1] = x[6] - x[8] + x[11] + x[14] - x[15];
+    w[2] = x[0] + x[7] + x[9] - x[12] + x[15];
+    w[3] = x[0] - x[1] + x[8] - x[10] + x[13];
+    w[4] = x[1] + x[2] + x[9] - x[11] - x[14];
+    w[5] = x[3] - x[2] + x[10] - x[12] + x[15];
+    w[6] = x[4] - x[0] - x[3] - x[11] + x[13];
+    w[7] = x[1] - x[4] - x[5] - x[12] - x[14];
+    w[8] = x[2] - x[5] - x[6] + x[13] - x[15];
+    w[9] = x[0] - x[3] + x[6] - x[7] + x[14];
+    w[10] = x[8] - x[1] - x[4] - x[7] + x[15];
+    w[11] = x[8] - x[0] - x[2] - x[5] + x[9];
+    w[12] = x[1] + x[3] - x[6] - x[9] + x[10];
+    w[13] = x[2] + x[4] + x[7] + x[10] + x[11];
+    w[14] = x[3] - x[5] + x[8] - x[11] - x[12];
+    w[15] = x[12] - x[4] - x[6] - x[9] + x[13];
+
+    Unroll<16>::Run([&](int i) { q[i] = BmwS(i % 5, w[i]) + h[(i + 1) & 15]; });
+
+    for (int i = 16; i < 18; i++) {
+        v4u64 t = BmwAddElement(m, h, i - 16);
+        for (int k = 0; k < 16; k += 4)
+            t += BmwS1(q[i - 16 + k]) + BmwS2(q[i - 15 + k]) + BmwS3(q[i - 14 + k]) + BmwS0(q[i - 13 + k]);
+        q[i] = t;
+    }
+    Unroll<14>::Run([&](int j) {
+        int i = j + 18;
+        q[i] = q[i - 16] + RotL(q[i - 15], 5) + q[i - 14] + RotL(q[i - 13], 11)
+            + q[i - 12] + RotL(q[i - 11], 27) + q[i - 10] + RotL(q[i - 9], 32)
+            + q[i - 8] + RotL(q[i - 7], 37) + q[i - 6] + RotL(q[i - 5], 43)
+            + q[i - 4] + RotL(q[i - 3], 53) + BmwS4(q[i - 2]) + BmwS5(q[i - 1])
+            + BmwAddElement(m, h, i - 16);
+    });
+
+    v4u64 xl = q[16] ^ q[17] ^ q[18] ^ q[19] ^ q[20] ^ q[21] ^ q[22] ^ q[23];
+    v4u64 xh = xl ^ q[24] ^ q[25] ^ q[26] ^ q[27] ^ q[28] ^ q[29] ^ q[30] ^ q[31];
+    dh[0] = ((xh << 5) ^ (q[16] >> 5) ^ m[0]) + (xl ^ q[24] ^ q[0]);
+    dh[1] = ((xh >> 7) ^ (q[17] << 8) ^ m[1]) + (xl ^ q[25] ^ q[1]);
+    dh[2] = ((xh >> 5) ^ (q[18] << 5) ^ m[2]) + (xl ^ q[26] ^ q[2]);
+    dh[3] = ((xh >> 1) ^ (q[19] << 5) ^ m[3]) + (xl ^ q[27] ^ q[3]);
+    dh[4] = ((xh >> 3) ^ q[20] ^ m[4]) + (xl ^ q[28] ^ q[4]);
+    dh[5] = ((xh << 6) ^ (q[21] >> 6) ^ m[5]) + (xl ^ q[29] ^ q[5]);
+    dh[6] = ((xh >> 4) ^ (q[22] << 6) ^ m[6]) + (xl ^ q[30] ^ q[6]);
+    dh[7] = ((xh >> 11) ^ (q[23] << 2) ^ m[7]) + (xl ^ q[31] ^ q[7]);
+    dh[8] = RotL(dh[4], 9) + (xh ^ q[24] ^ m[8]) + ((xl << 8) ^ q[23] ^ q[8]);
+    dh[9] = RotL(dh[5], 10) + (xh ^ q[25] ^ m[9]) + ((xl >> 6) ^ q[16] ^ q[9]);
+    dh[10] = RotL(dh[6], 11) + (xh ^ q[26] ^ m[10]) + ((xl << 6) ^ q[17] ^ q[10]);
+    dh[11] = RotL(dh[7], 12) + (xh ^ q[27] ^ m[11]) + ((xl << 4) ^ q[18] ^ q[11]);
+    dh[12] = RotL(dh[0], 13) + (xh ^ q[28] ^ m[12]) + ((xl >> 3) ^ q[19] ^ q[12]);
+    dh[13] = RotL(dh[1], 14) + (xh ^ q[29] ^ m[13]) + ((xl >> 4) ^ q[20] ^ q[13]);
+    dh[14] = RotL(dh[2], 15) + (xh ^ q[30] ^ m[14]) + ((xl >> 7) ^ q[21] ^ q[14]);
+    dh[15] = RotL(dh[3], 16) + (xh ^ q[31] ^ m[15]) + ((xl >> 2) ^ q[22] ^ q[15]);
+}
+
+inline void Bmw512Block(v4u64 h[16], const unsigned char* const block[4])
+{
+    v4u64 m[16];
+    for (int i = 0; i < 16; i++)
+        m[i] = LoadLE(block, 8 * i);
+    Bmw512Compress(m, h, h);
+}
+
+void Bmw512(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    v4u64 h[16];
+    for (int i = 0; i < 16; i++)
+        h[i] = Splat(BMW512_IV[i]);
+
+    const unsigned char* block[4];
+    size_t nBlocks = len / 128;
+    for (size_t b = 0; b < nBlocks; b++) {
+        Advance(in, block, 128 * b);
+        Bmw512Block(h, block);
+    }
+
+    size_t nRemain = len - 128 * nBlocks;
+    size_t nTail = nRemain < 120 ? 128 : 256;
+    TailBuffer tail(in, len, nRemain);
+    tail.SetByte(nRemain, 0x80);
+    tail.SetLE64(nTail - 8, (uint64_t)len << 3);
+    Bmw512Block(h, tail.block);
+    if (nTail == 256) {
+        tail.Select(128);
+        Bmw512Block(h, tail.block);
+    }
+
+    // Final compression of the chaining value under a constant key
+    v4u64 f[16], dh[16];
+    for (int i = 0; i < 16; i++)
+        f[i] = Splat(BMW512_FINAL[i]);
+    Bmw512Compress(h, f, dh);
+
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, 8 * i, dh[8 + i]);
+}
+
+////// Keccak-512
+
+const uint64_t KECCAK_RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+inline void __attribute__((always_inline)) KeccakChi(v4u64* a, const v4u64* b)
+{
+    a[0] = b[0] ^ (~b[1] & b[2]);
+    a[1] = b[1] ^ (~b[2] & b[3]);
+    a[2] = b[2] ^ (~b[3] & b[4]);
+    a[3] = b[3] ^ (~b[4] & b[0]);
+    a[4] = b[4] ^ (~b[0] & b[1]);
+}
+
+void KeccakF(v4u64 a[25])
+{
+    for (int r = 0; r < 24; r++) {
+        v4u64 c[5], d[5], b[25];
+
+        // theta
+        Unroll<5>::Run([&](int x) { c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20]; });
+        Unroll<5>::Run([&](int x) { d[x] = c[(x + 4) % 5] ^ RotL(c[(x + 1) % 5], 1); });
+        Unroll<25>::Run([&](int i) { a[i] ^= d[i % 5]; });
+
+        // rho and pi: lane (x, y) is rotated and moved to (y, 2x + 3y)
+        b[0] = a[0];
+        b[1] = RotL(a[6], 44);
+        b[2] = RotL(a[12], 43);
+        b[3] = RotL(a[18], 21);
+        b[4] = RotL(a[24], 14);
+        b[5] = RotL(a[3], 28);
+        b[6] = RotL(a[9], 20);
+        b[7] = RotL(a[10], 3);
+        b[8] = RotL(a[16], 45);
+        b[9] = RotL(a[22], 61);
+        b[10] = RotL(a[1], 1);
+        b[11] = RotL(a[7], 6);
+        b[12] = RotL(a[13], 25);
+        b[13] = RotL(a[19], 8);
+        b[14] = RotL(a[20], 18);
+        b[15] = RotL(a[4], 27);
+        b[16] = RotL(a[5], 36);
+        b[17] = RotL(a[11], 10);
+        b[18] = RotL(a[17], 15);
+        b[19] = RotL(a[23], 56);
+        b[20] = RotL(a[2], 62);
+        b[21] = RotL(a[8], 55);
+        b[22] = RotL(a[14], 39);
+        b[23] = RotL(a[15], 41);
+        b[24] = RotL(a[21], 2);
+
+        // chi and iota
+        KeccakChi(a + 0, b + 0);
+        KeccakChi(a + 5, b + 5);
+        KeccakChi(a + 10, b + 10);
+        KeccakChi(a + 15, b + 15);
+        KeccakChi(a + 20, b + 20);
+        a[0] ^= Splat(KECCAK_RC[r]);
+    }
+}
+
+void Keccak512(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    static const size_t RATE = 72;
+
+    v4u64 a[25];
+    for (int i = 0; i < 25; i++)
+        a[i] = Splat(0);
+
+    const unsigned char* block[4];
+    size_t nBlocks = len / RATE;
+    for (size_t b = 0; b < nBlocks; b++) {
+        Advance(in, block, RATE * b);
+        for (size_t i = 0; i < RATE / 8; i++)
+            a[i] ^= LoadLE(block, 8 * i);
+        KeccakF(a);
+    }
+
+    size_t nRemain = len - RATE * nBlocks;
+    TailBuffer tail(in, len, nRemain);
+    tail.SetByte(nRemain, 0x01);
+    tail.SetByte(RATE - 1, 0x80);
+    for (size_t i = 0; i < RATE / 8; i++)
+        a[i] ^= LoadLE(tail.block, 8 * i);
+    KeccakF(a);
+
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, 8 * i, a[i]);
+}
+
+////// Skein-512-512
+
+const uint64_t SKEIN512_IV[8] = {
+    0x4903ADFF749C51CEULL, 0x0D95DE399746DF03ULL, 0x8FD1934127C79BCEULL, 0x9A255629FF352CB1ULL,
+    0x5DB62599DF6CA7B0ULL, 0xEABE394CA9D5C3F4ULL, 0x991112C71A75B523ULL, 0xAE18A40B660FCC33ULL
+};
+
+const uint64_t SKEIN_FIRST = 1ULL << 62;
+const uint64_t SKEIN_FINAL = 1ULL << 63;
+const uint64_t SKEIN_TYPE_MSG = 48ULL << 56;
+const uint64_t SKEIN_TYPE_OUT = 63ULL << 56;
+
+inline void __attribute__((always_inline)) SkeinMix(v4u64& x0, v4u64& x1, int rc)
+{
+    x0 += x1;
+    x1 = RotL(x1, rc) ^ x0;
+}
+
+/** Four Threefish-512 rounds preceded by the injection of subkey s. */
+template <int s>
+inline void __attribute__((always_inline)) SkeinRounds(v4u64 p[8], const v4u64 k[9], const uint64_t t[3])
+{
+    p[0] += k[(s + 0) % 9];
+    p[1] += k[(s + 1) % 9];
+    p[2] += k[(s + 2) % 9];
+    p[3] += k[(s + 3) % 9];
+    p[4] += k[(s + 4) % 9];
+    p[5] += k[(s + 5) % 9] + Splat(t[s % 3]);
+    p[6] += k[(s + 6) % 9] + Splat(t[(s + 1) % 3]);
+    p[7] += k[(s + 7) % 9] + Splat((uint64_t)s);
+    if (s == 18)
+        return;
+    if ((s & 1) == 0) {
+        SkeinMix(p[0], p[1], 46); SkeinMix(p[2], p[3], 36); SkeinMix(p[4], p[5], 19); SkeinMix(p[6], p[7], 37);
+        SkeinMix(p[2], p[1], 33); SkeinMix(p[4], p[7], 27); SkeinMix(p[6], p[5], 14); SkeinMix(p[0], p[3], 42);
+        SkeinMix(p[4], p[1], 17); SkeinMix(p[6], p[3], 49); SkeinMix(p[0], p[5], 36); SkeinMix(p[2], p[7], 39);
+        SkeinMix(p[6], p[1], 44); SkeinMix(p[0], p[7], 9); SkeinMix(p[2], p[5], 54); SkeinMix(p[4], p[3], 56);
+    } else {
+        SkeinMix(p[0], p[1], 39); SkeinMix(p[2], p[3], 30); SkeinMix(p[4], p[5], 34); SkeinMix(p[6], p[7], 24);
+        SkeinMix(p[2], p[1], 13); SkeinMix(p[4], p[7], 50); SkeinMix(p[6], p[5], 10); SkeinMix(p[0], p[3], 17);
+        SkeinMix(p[4], p[1], 25); SkeinMix(p[6], p[3], 29); SkeinMix(p[0], p[5], 39); SkeinMix(p[2], p[7], 43);
+        SkeinMix(p[6], p[1], 8); SkeinMix(p[0], p[7], 35); SkeinMix(p[2], p[5], 56); SkeinMix(p[4], p[3], 22);
+    }
+}
+
+/** Threefish-512 in UBI chaining mode: h = E(h, tweak, m) ^ m. */
+void SkeinUBI(v4u64 h[8], const v4u64 m[8], uint64_t t0, uint64_t t1)
+{
+    v4u64 k[9], p[8];
+    const uint64_t t[3] = {t0, t1, t0 ^ t1};
+
+    k[8] = Splat(0x1BD11BDAA9FC1A22ULL);
+    for (int i = 0; i < 8; i++) {
+        k[i] = h[i];
+        k[8] ^= h[i];
+        p[i] = m[i];
+    }
+
+    SkeinRounds<0>(p, k, t);
+    SkeinRounds<1>(p, k, t);
+    SkeinRounds<2>(p, k, t);
+    SkeinRounds<3>(p, k, t);
+    SkeinRounds<4>(p, k, t);
+    SkeinRounds<5>(p, k, t);
+    SkeinRounds<6>(p, k, t);
+    SkeinRounds<7>(p, k, t);
+    SkeinRounds<8>(p, k, t);
+    SkeinRounds<9>(p, k, t);
+    SkeinRounds<10>(p, k, t);
+    SkeinRounds<11>(p, k, t);
+    SkeinRounds<12>(p, k, t);
+    SkeinRounds<13>(p, k, t);
+    SkeinRounds<14>(p, k, t);
+    SkeinRounds<15>(p, k, t);
+    SkeinRounds<16>(p, k, t);
+    SkeinRounds<17>(p, k, t);
+    SkeinRounds<18>(p, k, t); // final subkey only
+
+    for (int i = 0; i < 8; i++)
+        h[i] = m[i] ^ p[i];
+}
+
+inline void SkeinBlock(v4u64 h[8], const unsigned char* const block[4], uint64_t t0, uint64_t t1)
+{
+    v4u64 m[8];
+    for (int i = 0; i < 8; i++)
+        m[i] = LoadLE(block, 8 * i);
+    SkeinUBI(h, m, t0, t1);
+}
+
+void Skein512(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    v4u64 h[8];
+    for (int i = 0; i < 8; i++)
+        h[i] = Splat(SKEIN512_IV[i]);
+
+    // The last block is always processed with the final flag, even when it is full
+    const unsigned char* block[4];
+    size_t nBlocks = len ? (len + 63) / 64 : 1;
+    for (size_t b = 0; b + 1 < nBlocks; b++) {
+        Advance(in, block, 64 * b);
+        SkeinBlock(h, block, 64 * (b + 1), SKEIN_TYPE_MSG | (b == 0 ? SKEIN_FIRST : 0));
+    }
+
+    size_t nRemain = len - 64 * (nBlocks - 1);
+    TailBuffer tail(in, len, nRemain);
+    SkeinBlock(h, tail.block, len, SKEIN_TYPE_MSG | SKEIN_FINAL | (nBlocks == 1 ? SKEIN_FIRST : 0));
+
+    v4u64 zero[8];
+    for (int i = 0; i < 8; i++)
+        zero[i] = Splat(0);
+    SkeinUBI(h, zero, 8, SKEIN_TYPE_OUT | SKEIN_FIRST | SKEIN_FINAL);
+
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, 8 * i, h[i]);
+}
+
+////// SHA-512
+
+const uint64_t SHA512_K[80] = {
+    0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL, 0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL,
+    0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL, 0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+    0xD807AA98A3030242ULL, 0x12835B0145706FBEULL, 0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+    0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL, 0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+    0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL, 0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL,
+    0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL, 0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+    0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL, 0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL,
+    0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL, 0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+    0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL, 0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+    0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL, 0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+    0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL, 0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL,
+    0xD192E819D6EF5218ULL, 0xD69906245565A910ULL, 0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+    0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL, 0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL,
+    0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL, 0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+    0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL, 0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+    0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL, 0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+    0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL, 0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL,
+    0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL, 0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+    0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL, 0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL,
+    0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL, 0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+
+inline v4u64 Sha512Sigma0(v4u64 x) { return RotR(x, 28) ^ RotR(x, 34) ^ RotR(x, 39); }
+inline v4u64 Sha512Sigma1(v4u64 x) { return RotR(x, 14) ^ RotR(x, 18) ^ RotR(x, 41); }
+inline v4u64 Sha512sigma0(v4u64 x) { return RotR(x, 1) ^ RotR(x, 8) ^ (x >> 7); }
+inline v4u64 Sha512sigma1(v4u64 x) { return RotR(x, 19) ^ RotR(x, 61) ^ (x >> 6); }
+
+void Sha512Compress(v4u64 s[8], const unsigned char* const block[4])
+{
+    v4u64 w[16];
+    for (int i = 0; i < 16; i++)
+        w[i] = LoadBE(block, 8 * i);
+
+    v4u64 a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int n = 0; n < 80; n += 16) Unroll<16>::Run([&](int j) {
+        int i = n + j;
+        if (i >= 16)
+            w[j] += Sha512sigma1(w[(j - 2) & 15]) + w[(j - 7) & 15] + Sha512sigma0(w[(j - 15) & 15]);
+        v4u64 t1 = h + Sha512Sigma1(e) + (g ^ (e & (f ^ g))) + Splat(SHA512_K[i]) + w[j];
+        v4u64 t2 = Sha512Sigma0(a) + ((a & b) | (c & (a | b)));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    });
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    s[5] += f;
+    s[6] += g;
+    s[7] += h;
+}
+
+void Sha512(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    v4u64 s[8];
+    for (int i = 0; i < 8; i++)
+        s[i] = Splat(BLAKE512_IV[i]); // BLAKE-512 borrowed the SHA-512 initial value
+
+    const unsigned char* block[4];
+    size_t nBlocks = len / 128;
+    for (size_t b = 0; b < nBlocks; b++) {
+        Advance(in, block, 128 * b);
+        Sha512Compress(s, block);
+    }
+
+    size_t nRemain = len - 128 * nBlocks;
+    size_t nTail = nRemain < 112 ? 128 : 256;
+    TailBuffer tail(in, len, nRemain);
+    tail.SetByte(nRemain, 0x80);
+    tail.SetBE64(nTail - 8, (uint64_t)len << 3);
+    Sha512Compress(s, tail.block);
+    if (nTail == 256) {
+        tail.Select(128);
+        Sha512Compress(s, tail.block);
+    }
+
+    for (int i = 0; i < 8; i++)
+        StoreBE(out, 8 * i, s[i]);
+}
+
+////// CubeHash-512 (16 rounds per 32 byte block)
+
+const uint32_t CUBEHASH512_IV[32] = {
+    0x2AEA2A61, 0x50F494D4, 0x2D538B8B, 0x4167D83E, 0x3FEE2313, 0xC701CF8C, 0xCC39968E, 0x50AC5695,
+    0x4D42C787, 0xA647A8B3, 0x97CF0BEF, 0x825B4537, 0xEEF864D2, 0xF22090C4, 0xD0E5CD33, 0xA23911AE,
+    0xFCD398D9, 0x148FE485, 0x1B017BEF, 0xB6444532, 0x6A536159, 0x2FF5781C, 0x91FA7934, 0x0DBADEA9,
+    0xD65C8A2B, 0xA5A70E75, 0xB1C62456, 0xBC796576, 0x1921C8F7, 0xE7989AF1, 0x7795D246, 0xD43E3B44
+};
+
+/**
+ * One CubeHash round. x[0..15] and x[16..31] hold the x0jklm and x1jklm halves of the specification.
+ * Instead of moving words around, the swaps are tracked in the indices: on entry word i of the first
+ * half is at x[i ^ XM] and word i of the second half at x[16 + (i ^ YM)]. After a round with (0, 0)
+ * the words are found with (12, 3), and after a round with (12, 3) they are back in place.
+ */
+template <int XM, int YM>
+inline void __attribute__((always_inline)) CubehashRound(v4u32 x[32])
+{
+    Unroll<16>::Run([&](int i) { x[16 + (i ^ YM)] += x[i ^ XM]; });
+    Unroll<16>::Run([&](int i) { x[i] = RotL32(x[i], 7); });
+    Unroll<16>::Run([&](int i) { x[i ^ XM ^ 8] ^= x[16 + (i ^ YM)]; });
+    Unroll<16>::Run([&](int i) { x[16 + (i ^ YM ^ 2)] += x[i ^ XM ^ 8]; });
+    Unroll<16>::Run([&](int i) { x[i] = RotL32(x[i], 11); });
+    Unroll<16>::Run([&](int i) { x[i ^ XM ^ 12] ^= x[16 + (i ^ YM ^ 2)]; });
+}
+
+void CubehashRounds(v4u32 x[32])
+{
+    for (int r = 0; r < 16; r += 2) {
+        CubehashRound<0, 0>(x);
+        CubehashRound<12, 3>(x);
+    }
+}
+
+void Cubehash512(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    v4u32 x[32];
+    for (int i = 0; i < 32; i++)
+        x[i] = v4u32{CUBEHASH512_IV[i], CUBEHASH512_IV[i], CUBEHASH512_IV[i], CUBEHASH512_IV[i]};
+
+    const unsigned char* block[4];
+    size_t nBlocks = len / 32;
+    for (size_t b = 0; b < nBlocks; b++) {
+        Advance(in, block, 32 * b);
+        for (int i = 0; i < 8; i++)
+            x[i] ^= LoadLE32(block, 4 * i);
+        CubehashRounds(x);
+    }
+
+    size_t nRemain = len - 32 * nBlocks;
+    TailBuffer tail(in, len, nRemain);
+    tail.SetByte(nRemain, 0x80);
+    for (int i = 0; i < 8; i++)
+        x[i] ^= LoadLE32(tail.block, 4 * i);
+    CubehashRounds(x);
+
+    x[31] ^= v4u32{1, 1, 1, 1};
+    for (int i = 0; i < 10; i++)
+        CubehashRounds(x);
+
+    for (int i = 0; i < 16; i++)
+        StoreLE32(out, 4 * i, x[i]);
+}
+
+} // namespace
+
+#endif // BITCOIN_CRYPTO_X16R_X16R_4WAY_IMPL_H
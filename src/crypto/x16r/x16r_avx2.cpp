@@ -0,0 +1,20 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <crypto/x16r/x16r_4way_impl.h>
+
+namespace x16r_avx2 {
+
+void Blake512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len) { Blake512(out, in, len); }
+void Bmw512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len) { Bmw512(out, in, len); }
+void Keccak512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len) { Keccak512(out, in, len); }
+void Skein512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len) { Skein512(out, in, len); }
+void Cubehash512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len) { Cubehash512(out, in, len); }
+void Sha512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len) { Sha512(out, in, len); }
+
+}
+
+#endif
@@ -5,6 +5,11 @@
 #include <hash.h>
 #include <crypto/common.h>
 #include <crypto/hmac_sha512.h>
+#include <crypto/x16r/x16r_4way.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 
 
 inline uint32_t ROTL32(uint32_t x, int8_t r)
@@ -255,3 +260,225 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+static const char* const X16R_ALGO_NAMES[16] = {
+    "blake", "bmw", "groestl", "jh", "keccak", "skein", "luffa", "cubehash",
+    "shavite", "simd", "echo", "hamsi", "fugue", "shabal", "whirlpool", "sha512"
+};
+
+static std::atomic<bool> fX16RProfiling(false);
+static std::atomic<uint64_t> nX16RHashes[16];
+static std::atomic<uint64_t> nX16RBytes[16];
+static std::atomic<uint64_t> nX16RTimeNanos[16];
+
+const char* GetX16RAlgoName(int nAlgo)
+{
+    return nAlgo >= 0 && nAlgo < 16 ? X16R_ALGO_NAMES[nAlgo] : "unknown";
+}
+
+void SetX16RProfiling(bool fEnable)
+{
+    fX16RProfiling.store(fEnable, std::memory_order_relaxed);
+}
+
+bool IsX16RProfiling()
+{
+    return fX16RProfiling.load(std::memory_order_relaxed);
+}
+
+void GetX16RStats(std::vector<X16RAlgoStats>& vStats)
+{
+    vStats.resize(16);
+    for (int i = 0; i < 16; i++) {
+        vStats[i].nHashes = nX16RHashes[i].load(std::memory_order_relaxed);
+        vStats[i].nBytes = nX16RBytes[i].load(std::memory_order_relaxed);
+        vStats[i].nTimeNanos = nX16RTimeNanos[i].load(std::memory_order_relaxed);
+    }
+}
+
+void ResetX16RStats()
+{
+    for (int i = 0; i < 16; i++) {
+        nX16RHashes[i].store(0, std::memory_order_relaxed);
+        nX16RBytes[i].store(0, std::memory_order_relaxed);
+        nX16RTimeNanos[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/** Adds the lifetime of the object to the totals of an algorithm when profiling is enabled. */
+class X16RStepTimer
+{
+private:
+    const int nAlgo;
+    const size_t nHashes;
+    const size_t nBytes;
+    const bool fActive;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    X16RStepTimer(int nAlgoIn, size_t nHashesIn, size_t nLen) : nAlgo(nAlgoIn), nHashes(nHashesIn), nBytes(nHashesIn * nLen), fActive(IsX16RProfiling())
+    {
+        if (fActive)
+            start = std::chrono::steady_clock::now();
+    }
+
+    ~X16RStepTimer()
+    {
+        if (!fActive)
+            return;
+        auto nElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        nX16RHashes[nAlgo].fetch_add(nHashes, std::memory_order_relaxed);
+        nX16RBytes[nAlgo].fetch_add(nBytes, std::memory_order_relaxed);
+        nX16RTimeNanos[nAlgo].fetch_add(nElapsed, std::memory_order_relaxed);
+    }
+};
+
+void HashX16RStep(int nAlgo, const void* pin, size_t nLen, void* pout)
+{
+    X16RStepTimer timer(nAlgo, 1, nLen);
+
+    sph_blake512_context     ctx_blake;      //0
+    sph_bmw512_context       ctx_bmw;        //1
+    sph_groestl512_context   ctx_groestl;    //2
+    sph_jh512_context        ctx_jh;         //3
+    sph_keccak512_context    ctx_keccak;     //4
+    sph_skein512_context     ctx_skein;      //5
+    sph_luffa512_context     ctx_luffa;      //6
+    sph_cubehash512_context  ctx_cubehash;   //7
+    sph_shavite512_context   ctx_shavite;    //8
+    sph_simd512_context      ctx_simd;       //9
+    sph_echo512_context      ctx_echo;       //A
+    sph_hamsi512_context     ctx_hamsi;      //B
+    sph_fugue512_context     ctx_fugue;      //C
+    sph_shabal512_context    ctx_shabal;     //D
+    sph_whirlpool_context    ctx_whirlpool;  //E
+    sph_sha512_context       ctx_sha512;     //F
+
+    switch(nAlgo) {
+        case 0:
+            sph_blake512_init(&ctx_blake);
+            sph_blake512 (&ctx_blake, pin, nLen);
+            sph_blake512_close(&ctx_blake, pout);
+            break;
+        case 1:
+            sph_bmw512_init(&ctx_bmw);
+            sph_bmw512 (&ctx_bmw, pin, nLen);
+            sph_bmw512_close(&ctx_bmw, pout);
+            break;
+        case 2:
+            sph_groestl512_init(&ctx_groestl);
+            sph_groestl512 (&ctx_groestl, pin, nLen);
+            sph_groestl512_close(&ctx_groestl, pout);
+            break;
+        case 3:
+            sph_jh512_init(&ctx_jh);
+            sph_jh512 (&ctx_jh, pin, nLen);
+            sph_jh512_close(&ctx_jh, pout);
+            break;
+        case 4:
+            sph_keccak512_init(&ctx_keccak);
+            sph_keccak512 (&ctx_keccak, pin, nLen);
+            sph_keccak512_close(&ctx_keccak, pout);
+            break;
+        case 5:
+            sph_skein512_init(&ctx_skein);
+            sph_skein512 (&ctx_skein, pin, nLen);
+            sph_skein512_close(&ctx_skein, pout);
+            break;
+        case 6:
+            sph_luffa512_init(&ctx_luffa);
+            sph_luffa512 (&ctx_luffa, pin, nLen);
+            sph_luffa512_close(&ctx_luffa, pout);
+            break;
+        case 7:
+            sph_cubehash512_init(&ctx_cubehash);
+            sph_cubehash512 (&ctx_cubehash, pin, nLen);
+            sph_cubehash512_close(&ctx_cubehash, pout);
+            break;
+        case 8:
+            sph_shavite512_init(&ctx_shavite);
+            sph_shavite512(&ctx_shavite, pin, nLen);
+            sph_shavite512_close(&ctx_shavite, pout);
+            break;
+        case 9:
+            sph_simd512_init(&ctx_simd);
+            sph_simd512 (&ctx_simd, pin, nLen);
+            sph_simd512_close(&ctx_simd, pout);
+            break;
+        case 10:
+            sph_echo512_init(&ctx_echo);
+            sph_echo512 (&ctx_echo, pin, nLen);
+            sph_echo512_close(&ctx_echo, pout);
+            break;
+        case 11:
+            sph_hamsi512_init(&ctx_hamsi);
+            sph_hamsi512 (&ctx_hamsi, pin, nLen);
+            sph_hamsi512_close(&ctx_hamsi, pout);
+            break;
+        case 12:
+            sph_fugue512_init(&ctx_fugue);
+            sph_fugue512 (&ctx_fugue, pin, nLen);
+            sph_fugue512_close(&ctx_fugue, pout);
+            break;
+        case 13:
+            sph_shabal512_init(&ctx_shabal);
+            sph_shabal512 (&ctx_shabal, pin, nLen);
+            sph_shabal512_close(&ctx_shabal, pout);
+            break;
+        case 14:
+            sph_whirlpool_init(&ctx_whirlpool);
+            sph_whirlpool(&ctx_whirlpool, pin, nLen);
+            sph_whirlpool_close(&ctx_whirlpool, pout);
+            break;
+        case 15:
+            sph_sha512_init(&ctx_sha512);
+            sph_sha512 (&ctx_sha512, pin, nLen);
+            sph_sha512_close(&ctx_sha512, pout);
+            break;
+    }
+}
+
+void HashX16RMulti(const unsigned char* const* ppin, size_t nLen, const uint256* pSelectors, uint256* pout, size_t nCount)
+{
+    std::vector<uint512> vPrev(nCount), vNext(nCount);
+    std::vector<size_t> vLanes[16];
+    uint512 scratch;
+
+    for (int i = 0; i < 16; i++) {
+        for (auto& vAlgoLanes : vLanes)
+            vAlgoLanes.clear();
+        for (size_t k = 0; k < nCount; k++)
+            vLanes[GetHashSelection(pSelectors[k], i)].push_back(k);
+
+        size_t nStepLen = i == 0 ? nLen : 64;
+        for (int nAlgo = 0; nAlgo < 16; nAlgo++) {
+            const std::vector<size_t>& vAlgoLanes = vLanes[nAlgo];
+            size_t n = 0;
+
+            // A lone input is faster on the scalar code, otherwise pad the group by repeating its last input
+            X16RTransform4Way transform = X16RGetTransform4Way(nAlgo);
+            if (transform) {
+                for (; n + 1 < vAlgoLanes.size(); n += X16R_4WAY_LANES) {
+                    const unsigned char* in[X16R_4WAY_LANES];
+                    unsigned char* out[X16R_4WAY_LANES];
+                    for (size_t j = 0; j < X16R_4WAY_LANES; j++) {
+                        bool fPadding = n + j >= vAlgoLanes.size();
+                        size_t k = vAlgoLanes[fPadding ? vAlgoLanes.size() - 1 : n + j];
+                        in[j] = i == 0 ? ppin[k] : vPrev[k].begin();
+                        out[j] = fPadding ? scratch.begin() : vNext[k].begin();
+                    }
+                    X16RStepTimer timer(nAlgo, std::min(X16R_4WAY_LANES, vAlgoLanes.size() - n), nStepLen);
+                    transform(out, in, nStepLen);
+                }
+            }
+            for (; n < vAlgoLanes.size(); n++) {
+                size_t k = vAlgoLanes[n];
+                HashX16RStep(nAlgo, i == 0 ? ppin[k] : vPrev[k].begin(), nStepLen, vNext[k].begin());
+            }
+        }
+        vPrev.swap(vNext);
+    }
+
+    for (size_t k = 0; k < nCount; k++)
+        pout[k] = vPrev[k].trim256();
+}
@@ -18,8 +18,11 @@
 #include <chainparams.h>
 #include <checkpoints.h>
 #include <compat/sanity.h>
+#include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <crypto/x16r/x16r_4way.h>
 #include <fs.h>
+#include <hash.h>
 #include <httpserver.h>
 #include <httprpc.h>
 #include <index/txindex.h>
@@ -53,6 +56,8 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <veil/ringct/anon.h>
+#include <veil/proofofstake/kernel.h>
+#include <veil/zerocoin/accumulatormap.h>
 
 #ifndef WIN32
 #include <signal.h>
@@ -378,6 +383,8 @@ void SetupServerArgs()
     // When adding new options to the categories, please keep and ensure alphabetical ordering.
     gArgs.AddArg("-?", "Print this help message and exit", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-version", "Print version and exit", false, OptionsCategory::OPTIONS);
+    gArgs.AddArg("-accumulatorthreads=<n>", strprintf("Set the number of zerocoin accumulator checkpoint threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
+        -GetNumCores(), MAX_ACCUMULATOR_THREADS, DEFAULT_ACCUMULATOR_THREADS), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-alertnotify=<cmd>", "Execute command when a relevant alert is received or we see a really long fork (%s in cmd is replaced by message)", false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-assumevalid=<hex>", strprintf("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet: %s)", defaultChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnetChainParams->GetConsensus().defaultAssumeValid.GetHex()), false, OptionsCategory::OPTIONS);
     gArgs.AddArg("-blocksdir=<dir>", "Specify blocks directory (default: <datadir>/blocks)", false, OptionsCategory::OPTIONS);
@@ -499,6 +506,9 @@ void SetupServerArgs()
     gArgs.AddArg("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-mocktime=<n>", "Replace actual time with <n> seconds since epoch (default: 0)", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-maxmlsagcachesize=<n>", strprintf("Limit MLSAG ring signature cache size to <n> MiB (default: %u)", DEFAULT_MAX_MLSAG_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-maxrangeproofcachesize=<n>", strprintf("Limit range proof cache size to <n> MiB (default: %u)", DEFAULT_MAX_RANGEPROOF_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-maxzcspendcachesize=<n>", strprintf("Limit verified zerocoin spend cache size to <n> MiB (default: %u)", DEFAULT_MAX_ZCSPEND_CACHE_SIZE), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-maxtxfee=<amt>", strprintf("Maximum total fees (in %s) to use in a single wallet transaction or raw transaction; setting this too low may abort large transactions (default: %s)",
         CURRENCY_UNIT, FormatMoney(DEFAULT_TRANSACTION_MAXFEE)), false, OptionsCategory::DEBUG_TEST);
@@ -1008,6 +1018,7 @@ bool AppInitParameterInteraction()
             InitWarning(strprintf(_("Unsupported logging category %s=%s."), "-debugexclude", cat));
         }
     }
+    SetX16RProfiling(LogAcceptCategory(BCLog::X16R));
 
     // Check for -debugnet
     if (gArgs.GetBoolArg("-debugnet", false))
@@ -1080,6 +1091,15 @@ bool AppInitParameterInteraction()
     else if (nScriptCheckThreads > MAX_SCRIPTCHECK_THREADS)
         nScriptCheckThreads = MAX_SCRIPTCHECK_THREADS;
 
+    // -accumulatorthreads=0 means autodetect, but nAccumulatorThreads==0 means no concurrency
+    nAccumulatorThreads = gArgs.GetArg("-accumulatorthreads", DEFAULT_ACCUMULATOR_THREADS);
+    if (nAccumulatorThreads <= 0)
+        nAccumulatorThreads += GetNumCores();
+    if (nAccumulatorThreads <= 1)
+        nAccumulatorThreads = 0;
+    else if (nAccumulatorThreads > MAX_ACCUMULATOR_THREADS)
+        nAccumulatorThreads = MAX_ACCUMULATOR_THREADS;
+
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg = gArgs.GetArg("-prune", 0);
     if (nPruneArg < 0) {
@@ -1226,6 +1246,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string x16r_algo = X16RAutoDetect();
+    LogPrintf("Using the '%s' X16R implementation\n", x16r_algo);
     RandomInit();
     ECC_Start();
     ECC_Start_Stealth();
@@ -1291,11 +1313,28 @@ bool AppInitMain()
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    InitRangeProofCache();
+    InitMLSAGCache();
+    InitZerocoinSpendCache();
 
     LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadMLSAGCheck);
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadRangeProofCheck);
+        for (int i=0; i<std::min(nScriptCheckThreads, MAX_HEADERPOWCHECK_THREADS)-1; i++)
+            threadGroup.create_thread(&ThreadHeaderPoWCheck);
+        for (int i=0; i<std::min(nScriptCheckThreads, MAX_STAGEDSPENDCHECK_THREADS)-1; i++)
+            threadGroup.create_thread(&ThreadStagedSpendCheck);
+    }
+
+    LogPrintf("Using %u threads for accumulator checkpoints\n", nAccumulatorThreads);
+    if (nAccumulatorThreads) {
+        for (int i=0; i<nAccumulatorThreads-1; i++)
+            threadGroup.create_thread(&ThreadAccumulatorCheck);
     }
 
     // Start the lightweight task scheduler thread
@@ -1500,6 +1539,8 @@ bool AppInitMain()
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
+    int64_t nRCTOutputCache = std::min(nTotalCache / 8, nMaxRCTOutputCache << 20);
+    nTotalCache -= nRCTOutputCache;
     nCoinCacheUsage = nTotalCache; // the rest goes to in-memory cache
     int64_t nMempoolSizeMax = gArgs.GetArg("-maxmempool", DEFAULT_MAX_MEMPOOL_SIZE) * 1000000;
     LogPrintf("Cache configuration:\n");
@@ -1508,6 +1549,7 @@ bool AppInitMain()
         LogPrintf("* Using %.1fMiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
     }
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
+    LogPrintf("* Using %.1fMiB for RingCT output cache\n", nRCTOutputCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
     bool fLoaded = false;
@@ -1530,6 +1572,7 @@ bool AppInitMain()
                 // fails if it's still open from the previous loop. Close it first:
                 pblocktree.reset();
                 pblocktree.reset(new CBlockTreeDB(nBlockTreeDBCache, false, fReset));
+                pblocktree->InitRCTOutputCache(nRCTOutputCache);
 
                 //zerocoinDB
                 pzerocoinDB.reset();
@@ -1542,6 +1585,19 @@ bool AppInitMain()
                         CleanupBlockRevFiles();
                 }
 
+                // Older versions cannot read the entries of a newer format, and entries are only written in the
+                // newest one, so the database is marked with its format before it is used
+                int nBlockIndexVersion = 0;
+                pblocktree->ReadBlockIndexVersion(nBlockIndexVersion);
+                if (nBlockIndexVersion > BLOCK_INDEX_VERSION) {
+                    strLoadError = _("The block database was written by a newer version. You need to rebuild the database using -reindex");
+                    break;
+                }
+                if (nBlockIndexVersion < BLOCK_INDEX_VERSION && !pblocktree->WriteBlockIndexVersion(BLOCK_INDEX_VERSION)) {
+                    strLoadError = _("Error upgrading block database");
+                    break;
+                }
+
                 if (ShutdownRequested()) break;
 
                 // LoadBlockIndex will load fHavePruned if we've ever removed a
@@ -1847,8 +1903,11 @@ bool AppInitMain()
     g_wallet_init_interface.Start(scheduler);
 
     //Start staking thread last
-    if (gArgs.GetBoolArg("-staking", true) && !gArgs.GetBoolArg("-exchangesandservicesmode", false))
+    if (gArgs.GetBoolArg("-staking", true) && !gArgs.GetBoolArg("-exchangesandservicesmode", false)) {
         threadGroupStaking.create_thread(&ThreadStakeMiner);
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroupStaking.create_thread(&ThreadStakeKernelCheck);
+    }
 
     //Start block staging thread
     threadGroupStaging.create_thread(&ThreadStaging);
@@ -46,6 +46,26 @@ void Accumulator::increment(const CBigNum& bnValue) {
     this->value = this->value.pow_mod(bnValue, this->params->accumulatorModulus);
 }
 
+void Accumulator::incrementBatch(const std::vector<CBigNum>& vValues) {
+    if (vValues.empty())
+        return;
+
+    // (v^a)^b = v^(a*b) mod N, so multiply the elements together and exponentiate once.
+    // The product is built as a tree so that the multiplications stay balanced in size.
+    std::vector<CBigNum> vProducts(vValues);
+    while (vProducts.size() > 1) {
+        std::vector<CBigNum> vNext;
+        vNext.reserve((vProducts.size() + 1) / 2);
+        for (unsigned int i = 0; i + 1 < vProducts.size(); i += 2)
+            vNext.emplace_back(vProducts[i] * vProducts[i + 1]);
+        if (vProducts.size() % 2)
+            vNext.emplace_back(vProducts.back());
+        vProducts.swap(vNext);
+    }
+
+    increment(vProducts[0]);
+}
+
 bool Accumulator::accumulate(const PublicCoin& coin) {
     // Make sure we're initialized
     if(!(this->value))
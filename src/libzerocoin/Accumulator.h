@@ -62,6 +62,14 @@ public:
     bool accumulate(const PublicCoin &coin);
     void increment(const CBigNum& bnValue);
 
+    /**
+     * Add a set of values to the accumulator without any checks. The values are
+     * multiplied together first so that only a single modular exponentiation is done.
+     *
+     * @param vValues    the values to add
+     */
+    void incrementBatch(const std::vector<CBigNum>& vValues);
+
     CoinDenomination getDenomination() const;
     /** Get the accumulator result
      *
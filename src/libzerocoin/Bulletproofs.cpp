@@ -138,13 +138,16 @@ bool Bulletproofs::Verify(const ZerocoinParams* ZCp,
     CBigNum x1 = CBigNum(hasher.GetHash()) % q;
 
     CBigNum u_inner = u_inner_prod.pow_mod(x1,p);
-    CBigNum P_inner = P_inner_prod.mul_mod(u_inner.pow_mod(z,p),p);
 
     // Starting the actual protocol
     int N1 = pi[0].size();
     CBigNum x, Ak, Bk;
     CBN_vector xlist;
 
+    // P_inner = P_inner_prod * u_inner^z * prod(Ak^(x^2) * Bk^(x^-2)), in a single multi-exponentiation
+    CBN_vector P_bases(1, u_inner);
+    CBN_vector P_expos(1, z);
+
     for(int i=0; i<N1; i++) {
         Ak = pi[0][i];
         Bk = pi[1][i];
@@ -154,10 +157,14 @@ bool Bulletproofs::Verify(const ZerocoinParams* ZCp,
 
         xlist.push_back(x);
 
-        P_inner = P_inner.mul_mod(
-                (Ak.pow_mod(x.pow_mod(2,q),p)).mul_mod(Bk.pow_mod(x.pow_mod(-2,q),p),p),p);
+        P_bases.push_back(Ak);
+        P_expos.push_back(x.pow_mod(2,q));
+        P_bases.push_back(Bk);
+        P_expos.push_back(x.pow_mod(-2,q));
     }
 
+    CBigNum P_inner = P_inner_prod.mul_mod(MultiExp(P_bases, P_expos, p),p);
+
     CBigNum z2 = final_a[0][0].mul_mod(final_b[0][0],q);
     CBN_vector gh_final = getFinal_gh(ck_inner_g[0], ck_inner_h[0], xlist);
 
@@ -339,9 +346,9 @@ bool Bulletproofs::testComsCorrect(const CBN_vector gh_sets,
         const CBN_matrix final_a, const CBN_matrix final_b, const CBigNum z)
 {
     const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
-    CBigNum Ptest = gh_sets[0].pow_mod(final_a[0][0],p);
-    Ptest = Ptest.mul_mod(gh_sets[1].pow_mod(final_b[0][0],p),p);
-    Ptest = Ptest.mul_mod(u_inner.pow_mod(z,p),p);
+    const CBN_vector bases = {gh_sets[0], gh_sets[1], u_inner};
+    const CBN_vector expos = {final_a[0][0], final_b[0][0], z};
+    CBigNum Ptest = MultiExp(bases, expos, p);
     return (Ptest == P_inner);
 }
 
@@ -389,12 +396,9 @@ CBN_vector Bulletproofs::getFinal_gh(const CBN_vector gs, const CBN_vector hs, C
         sh_expo.push_back(sh_i);
     }
 
-    CBN_vector ghfinal(2, CBigNum(1));
-
-    for(int i=0; i<n; i++) {
-        ghfinal[0] = ghfinal[0].mul_mod(gs[i].pow_mod(sg_expo[i],p),p);
-        ghfinal[1] = ghfinal[1].mul_mod(hs[i].pow_mod(sh_expo[i],p),p);
-    }
+    CBN_vector ghfinal(2);
+    ghfinal[0] = MultiExp(gs, sg_expo, p);
+    ghfinal[1] = MultiExp(CBN_vector(hs.begin(), hs.begin() + n), sh_expo, p);
 
     return ghfinal;
 }
@@ -20,6 +20,7 @@ enum  CoinDenomination {
 };
 
 // Order is with the Smallest Denomination first and is important for a particular routine that this order is maintained
+// CDenominationArray in chain.h keeps one value per entry of this list
 const std::vector<CoinDenomination> zerocoinDenomList = {ZQ_TEN, ZQ_ONE_HUNDRED, ZQ_ONE_THOUSAND, ZQ_TEN_THOUSAND};
 // These are the max number you'd need at any one Denomination before moving to the higher denomination. Last number is 1, since it's the max number of
 // possible spends at the moment (20,000)    /
@@ -0,0 +1,84 @@
+/**
+* @file       FixedBaseExp.cpp
+*
+* @brief      Fixed-base windowed exponentiation for the Zerocoin groups.
+*
+* @copyright  Copyright 2019 The Veil developers
+* @license    This project is released under the MIT license.
+**/
+
+#include "FixedBaseExp.h"
+
+namespace libzerocoin {
+
+/** Nonzero digits per table row */
+static const unsigned int FIXED_BASE_DIGITS = (1 << FIXED_BASE_WINDOW) - 1;
+
+static_assert(FIXED_BASE_WINDOW == 4, "Exp reads the exponent digits as nibbles");
+
+FixedBaseExp& FixedBaseExp::operator=(const FixedBaseExp&)
+{
+	std::lock_guard<std::mutex> lock(cs);
+	table.reset();
+	return *this;
+}
+
+std::shared_ptr<const FixedBaseExp::Table> FixedBaseExp::GetTable(const CBigNum& base, const CBigNum& modulus, const CBigNum& order) const
+{
+	std::lock_guard<std::mutex> lock(cs);
+	if (table && table->base == base && table->modulus == modulus)
+		return table;
+
+	std::shared_ptr<Table> tableNew = std::make_shared<Table>();
+	tableNew->base = base;
+	tableNew->modulus = modulus;
+
+	size_t nRows = (order.bitSize() + FIXED_BASE_WINDOW - 1) / FIXED_BASE_WINDOW;
+	size_t nBytes = nRows * FIXED_BASE_DIGITS * ((modulus.bitSize() + 7) / 8);
+	if (nBytes <= MAX_FIXED_BASE_TABLE_BYTES) {
+		tableNew->vPowers.reserve(nRows * FIXED_BASE_DIGITS);
+		CBigNum rowBase = base % modulus;
+		for (size_t i = 0; i < nRows; i++) {
+			CBigNum power = rowBase;
+			tableNew->vPowers.emplace_back(power);
+			for (unsigned int d = 2; d <= FIXED_BASE_DIGITS; d++) {
+				power = power.mul_mod(rowBase, modulus);
+				tableNew->vPowers.emplace_back(power);
+			}
+			// The next row starts at base^(2^(FIXED_BASE_WINDOW * (i + 1)))
+			rowBase = power.mul_mod(rowBase, modulus);
+		}
+	}
+
+	table = tableNew;
+	return table;
+}
+
+CBigNum FixedBaseExp::Exp(const CBigNum& base, const CBigNum& x, const CBigNum& modulus, const CBigNum& order) const
+{
+	if (x < CBigNum(0))
+		return base.pow_mod(x, modulus);
+
+	std::shared_ptr<const Table> tableExp = GetTable(base, modulus, order);
+	if (tableExp->vPowers.empty())
+		return base.pow_mod(x, modulus);
+
+	// getvch() is little endian, so digit i is nibble i counting from the least significant byte
+	std::vector<unsigned char> vch = (x < order ? x : x % order).getvch();
+	CBigNum result(1);
+	bool fOne = true;
+	for (size_t i = 0; i < vch.size() * 8 / FIXED_BASE_WINDOW; i++) {
+		unsigned int d = (vch[i / 2] >> (FIXED_BASE_WINDOW * (i % 2))) & FIXED_BASE_DIGITS;
+		if (!d)
+			continue;
+		size_t nIndex = i * FIXED_BASE_DIGITS + d - 1;
+		if (nIndex >= tableExp->vPowers.size())
+			return base.pow_mod(x, modulus);
+		result = fOne ? tableExp->vPowers[nIndex] : result.mul_mod(tableExp->vPowers[nIndex], modulus);
+		fOne = false;
+	}
+
+	return result;
+}
+
+} /* namespace libzerocoin */
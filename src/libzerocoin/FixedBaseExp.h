@@ -0,0 +1,65 @@
+/**
+* @file       FixedBaseExp.h
+*
+* @brief      Fixed-base windowed exponentiation for the Zerocoin groups.
+*
+* @copyright  Copyright 2019 The Veil developers
+* @license    This project is released under the MIT license.
+**/
+
+#ifndef FIXEDBASEEXP_H_
+#define FIXEDBASEEXP_H_
+
+#include "bignum.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace libzerocoin {
+
+/** Width in bits of the exponent digits looked up in a fixed-base table */
+static const unsigned int FIXED_BASE_WINDOW = 4;
+
+/** A table that would take more memory than this is not built, and its base always uses pow_mod */
+static const size_t MAX_FIXED_BASE_TABLE_BYTES = 1 << 20;
+
+/**
+ * Exponentiation of a fixed base of prime order. The first call builds a table of the base raised to every
+ * FIXED_BASE_WINDOW bit digit at every digit position of an exponent below the order, after which an exponentiation
+ * is one modular multiplication per nonzero digit and needs no squarings.
+ *
+ * Table lookups depend on the exponent digits, so unlike pow_mod this does not try to be constant time. It must only
+ * be used with public exponents, never with serials, randomness or proof nonces.
+ */
+class FixedBaseExp {
+public:
+	FixedBaseExp() {}
+
+	/** Copies start without a table, so a group that is copied and then changed never uses stale powers */
+	FixedBaseExp(const FixedBaseExp&) {}
+	FixedBaseExp& operator=(const FixedBaseExp&);
+
+	/**
+	 * Computes base^x mod modulus, where base has order "order". Exponents of order or more are reduced first.
+	 * Negative exponents, and bases whose table would be too large, fall back to pow_mod.
+	 */
+	CBigNum Exp(const CBigNum& base, const CBigNum& x, const CBigNum& modulus, const CBigNum& order) const;
+
+private:
+	struct Table {
+		CBigNum base;
+		CBigNum modulus;
+		/** vPowers[i * (2^FIXED_BASE_WINDOW - 1) + d - 1] = base^(d * 2^(FIXED_BASE_WINDOW * i)), empty if too large */
+		std::vector<CBigNum> vPowers;
+	};
+
+	mutable std::mutex cs;
+	mutable std::shared_ptr<const Table> table;
+
+	std::shared_ptr<const Table> GetTable(const CBigNum& base, const CBigNum& modulus, const CBigNum& order) const;
+};
+
+} /* namespace libzerocoin */
+
+#endif /* FIXEDBASEEXP_H_ */
@@ -0,0 +1,171 @@
+/**
+* @file       MultiExp.cpp
+*
+* @brief      Simultaneous multi-exponentiation for the Zerocoin groups.
+*
+* @copyright  Copyright 2019 The Veil developers
+* @license    This project is released under the MIT license.
+**/
+
+#include "MultiExp.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace libzerocoin {
+
+/** Precomputed powers and buckets are not allowed to take more memory than this */
+static const size_t MAX_MULTI_EXP_TABLE_BYTES = 1 << 22;
+
+/** Bits [nBit, nBit + nWidth) of the little endian magnitude vch */
+static unsigned int GetWindow(const std::vector<unsigned char>& vch, size_t nBit, unsigned int nWidth)
+{
+	unsigned int nWindow = 0;
+	for (unsigned int k = 0; k < nWidth; k++) {
+		size_t nPos = nBit + k;
+		if (nPos / 8 < vch.size() && (vch[nPos / 8] >> (nPos % 8)) & 1)
+			nWindow |= 1u << k;
+	}
+	return nWindow;
+}
+
+static void MulInto(CBigNum& result, bool& fOne, const CBigNum& factor, const CBigNum& modulus)
+{
+	result = fOne ? factor : result.mul_mod(factor, modulus);
+	fOne = false;
+}
+
+/** Straus: every base gets a table of its first 2^nWidth - 1 powers, and one squaring chain is shared by all of them */
+static CBigNum MultiExpStraus(const CBN_vector& vBases, const std::vector<std::vector<unsigned char>>& vDigits,
+		size_t nBits, unsigned int nWidth, const CBigNum& modulus)
+{
+	const unsigned int nPowers = (1u << nWidth) - 1;
+	std::vector<CBN_vector> vTables(vBases.size());
+	for (size_t i = 0; i < vBases.size(); i++) {
+		vTables[i].reserve(nPowers);
+		vTables[i].emplace_back(vBases[i]);
+		for (unsigned int d = 2; d <= nPowers; d++)
+			vTables[i].emplace_back(vTables[i].back().mul_mod(vBases[i], modulus));
+	}
+
+	CBigNum result(1);
+	bool fOne = true;
+	for (size_t nWindow = (nBits + nWidth - 1) / nWidth; nWindow-- > 0;) {
+		for (unsigned int k = 0; k < nWidth && !fOne; k++)
+			result = result.mul_mod(result, modulus);
+		for (size_t i = 0; i < vBases.size(); i++) {
+			unsigned int d = GetWindow(vDigits[i], nWindow * nWidth, nWidth);
+			if (d)
+				MulInto(result, fOne, vTables[i][d - 1], modulus);
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Pippenger: for each window the bases are sorted into buckets by their digit, and the buckets are combined with
+ * a running product so that bucket d ends up raised to d without any table of powers.
+ */
+static CBigNum MultiExpPippenger(const CBN_vector& vBases, const std::vector<std::vector<unsigned char>>& vDigits,
+		size_t nBits, unsigned int nWidth, const CBigNum& modulus)
+{
+	const unsigned int nBuckets = (1u << nWidth) - 1;
+	CBN_vector vBuckets(nBuckets);
+	std::vector<bool> vUsed(nBuckets);
+
+	CBigNum result(1);
+	bool fOne = true;
+	for (size_t nWindow = (nBits + nWidth - 1) / nWidth; nWindow-- > 0;) {
+		for (unsigned int k = 0; k < nWidth && !fOne; k++)
+			result = result.mul_mod(result, modulus);
+
+		std::fill(vUsed.begin(), vUsed.end(), false);
+		for (size_t i = 0; i < vBases.size(); i++) {
+			unsigned int d = GetWindow(vDigits[i], nWindow * nWidth, nWidth);
+			if (!d)
+				continue;
+			bool fEmpty = !vUsed[d - 1];
+			MulInto(vBuckets[d - 1], fEmpty, vBases[i], modulus);
+			vUsed[d - 1] = true;
+		}
+
+		// running = prod_{j >= d} bucket_j, so multiplying it in for every d gives prod_d bucket_d^d
+		CBigNum running, sum;
+		bool fRunningOne = true, fSumOne = true;
+		for (unsigned int d = nBuckets; d > 0; d--) {
+			if (vUsed[d - 1])
+				MulInto(running, fRunningOne, vBuckets[d - 1], modulus);
+			if (!fRunningOne)
+				MulInto(sum, fSumOne, running, modulus);
+		}
+		if (!fSumOne)
+			MulInto(result, fOne, sum, modulus);
+	}
+
+	return result;
+}
+
+CBigNum MultiExp(const CBN_vector& vBases, const CBN_vector& vExps, const CBigNum& modulus)
+{
+	if (vBases.size() != vExps.size())
+		throw std::runtime_error("MultiExp: the number of bases and exponents differ");
+
+	CBN_vector vTermBases;
+	std::vector<std::vector<unsigned char>> vDigits;
+	size_t nBits = 0;
+	size_t nLastTerm = 0;
+	for (size_t i = 0; i < vBases.size(); i++) {
+		if (vExps[i] == CBigNum(0))
+			continue;
+		if (vExps[i] < CBigNum(0)) {
+			vTermBases.emplace_back(vBases[i].inverse(modulus));
+			vDigits.emplace_back((-vExps[i]).getvch());
+		} else {
+			vTermBases.emplace_back(vBases[i] % modulus);
+			vDigits.emplace_back(vExps[i].getvch());
+		}
+		nBits = std::max(nBits, (size_t)vExps[i].bitSize());
+		nLastTerm = i;
+	}
+
+	if (vTermBases.empty())
+		return CBigNum(1);
+	if (vTermBases.size() == 1)
+		return vBases[nLastTerm].pow_mod(vExps[nLastTerm], modulus);
+
+	// Cost of each method in modular multiplications, squarings included
+	const size_t n = vTermBases.size();
+	const size_t nElementBytes = (modulus.bitSize() + 7) / 8;
+	size_t nBestCost = 0;
+	unsigned int nBestWidth = 0;
+	bool fBestStraus = false;
+	for (unsigned int w = 1; w <= MAX_MULTI_EXP_WINDOW; w++) {
+		const size_t nWindows = (nBits + w - 1) / w;
+		const size_t nPowers = (1u << w) - 1;
+
+		if (n * nPowers * nElementBytes <= MAX_MULTI_EXP_TABLE_BYTES) {
+			size_t nCost = n * (nPowers - 1) + n * nWindows + nBits;
+			if (!nBestWidth || nCost < nBestCost) {
+				nBestCost = nCost;
+				nBestWidth = w;
+				fBestStraus = true;
+			}
+		}
+
+		if (nPowers * nElementBytes <= MAX_MULTI_EXP_TABLE_BYTES) {
+			size_t nCost = nWindows * (n + 2 * nPowers) + nBits;
+			if (!nBestWidth || nCost < nBestCost) {
+				nBestCost = nCost;
+				nBestWidth = w;
+				fBestStraus = false;
+			}
+		}
+	}
+
+	if (fBestStraus)
+		return MultiExpStraus(vTermBases, vDigits, nBits, nBestWidth, modulus);
+	return MultiExpPippenger(vTermBases, vDigits, nBits, nBestWidth, modulus);
+}
+
+} /* namespace libzerocoin */
@@ -0,0 +1,34 @@
+/**
+* @file       MultiExp.h
+*
+* @brief      Simultaneous multi-exponentiation for the Zerocoin groups.
+*
+* @copyright  Copyright 2019 The Veil developers
+* @license    This project is released under the MIT license.
+**/
+
+#ifndef MULTIEXP_H_
+#define MULTIEXP_H_
+
+#include "bignum.h"
+#include "ZerocoinDefines.h"
+
+namespace libzerocoin {
+
+/** Widest window tried by either multi-exponentiation method */
+static const unsigned int MAX_MULTI_EXP_WINDOW = 12;
+
+/**
+ * Computes the product of vBases[i]^vExps[i] mod modulus. All the exponents are processed together, so the
+ * squarings are shared by every base instead of being repeated once per pow_mod.
+ *
+ * Depending on the number of bases and the size of the exponents this uses either Straus' method, with a table of
+ * small powers per base, or Pippenger's bucket method, whichever needs fewer modular multiplications. Negative
+ * exponents use the inverse of their base. Like FixedBaseExp, this does not try to be constant time, so it is only
+ * used for the public exponents of the verifier; the prover's commitments keep pow_mod for their secret blinders.
+ */
+CBigNum MultiExp(const CBN_vector& vBases, const CBN_vector& vExps, const CBigNum& modulus);
+
+} /* namespace libzerocoin */
+
+#endif /* MULTIEXP_H_ */
@@ -15,6 +15,7 @@
 #define PARAMS_H_
 
 #include "bignum.h"
+#include "FixedBaseExp.h"
 #include "ZerocoinDefines.h"
 
 namespace libzerocoin {
@@ -68,6 +69,27 @@ public:
 	 */
 	CBigNum groupOrder;
 
+	/**
+	 * Computes g^x mod modulus with a precomputed table of powers of g. This is not constant time, so it is only for
+	 * exponents that are public, such as the responses checked by a verifier. Secrets go through pow_mod.
+	 * @param x the exponent
+	 * @return g^x mod modulus
+	 */
+	CBigNum ExpG(const CBigNum& x) const { return fixedG.Exp(g, x, modulus, groupOrder); }
+
+	/**
+	 * Computes h^x mod modulus with a precomputed table of powers of h. Like ExpG, only for public exponents.
+	 * @param x the exponent
+	 * @return h^x mod modulus
+	 */
+	CBigNum ExpH(const CBigNum& x) const { return fixedH.Exp(h, x, modulus, groupOrder); }
+
+	/**
+	 * Tables for ExpG and ExpH, built on first use and not serialized.
+	 */
+	FixedBaseExp fixedG;
+	FixedBaseExp fixedH;
+
 	ADD_SERIALIZE_METHODS;
   template <typename Stream, typename Operation>  inline void SerializationOp(Stream& s, Operation ser_action) {
 		    READWRITE(initialized);
@@ -601,7 +601,7 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<SerialNumberSoKProof> &proofs
     CBN_vector xPowersPositive, xPowersNegative, yPowers;
 
     CBN_vector test_vec(n, CBigNum(0));
-    CBigNum comTest = CBigNum(1);
+    CBN_vector comTest_bases, comTest_expos;
     CBigNum gamma;
 
     for(unsigned int w=0; w<proofs2.size(); w++)
@@ -655,15 +655,21 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<SerialNumberSoKProof> &proofs
 
         rho = proofs2[w].signature.rho;
 
-        CBigNum ComR = pedersenCommitment(params, CBN_vector(1, CBigNum(0)), -rho);
-        ComR = ComR.mul_mod(ComD.pow_mod(proofs2[w].xPowersPos[2*m+1],p),p);
+        CBN_vector R_bases(1, ComD);
+        CBN_vector R_expos(1, proofs2[w].xPowersPos[2*m+1]);
 
         for(int i=1; i<m+1; i++) {
-            ComR = ComR.mul_mod(ComA[i-1].pow_mod(proofs2[w].xPowersPos[i].mul_mod(proofs2[w].yPowers[i],q),p),p);
-            ComR = ComR.mul_mod(ComB[i-1].pow_mod(proofs2[w].xPowersNeg[i],p),p);
-            ComR = ComR.mul_mod(ComC_[i-1].pow_mod(proofs2[w].xPowersPos[m+i],p),p);
+            R_bases.push_back(ComA[i-1]);
+            R_expos.push_back(proofs2[w].xPowersPos[i].mul_mod(proofs2[w].yPowers[i],q));
+            R_bases.push_back(ComB[i-1]);
+            R_expos.push_back(proofs2[w].xPowersNeg[i]);
+            R_bases.push_back(ComC_[i-1]);
+            R_expos.push_back(proofs2[w].xPowersPos[m+i]);
         }
 
+        CBigNum ComR = pedersenCommitment(params, CBN_vector(1, CBigNum(0)), -rho);
+        ComR = ComR.mul_mod(MultiExp(R_bases, R_expos, p),p);
+
         // append proof4
         proofs2[w].ComR = ComR;
 
@@ -744,14 +750,15 @@ bool SerialNumberSoKProof::BatchVerify(std::vector<SerialNumberSoKProof> &proofs
 
         addVectors_mod(test_vec, temp_v, test_vec, q);
 
-        comTest = comTest.mul_mod(
-                        ((ComR.pow_mod(-1,p)).mul_mod(comRdash,p)).pow_mod(gamma,p),p);
+        comTest_bases.push_back((ComR.pow_mod(-1,p)).mul_mod(comRdash,p));
+        comTest_expos.push_back(gamma);
 
 
     }
 
 
     CBigNum test = pedersenCommitment(proofs2[0].signature.params, test_vec, CBigNum(0));
+    CBigNum comTest = MultiExp(comTest_bases, comTest_expos, p);
 
     if(test != comTest) {
         LogPrintf("BatchVerify failed: different test and comTest\n");
@@ -780,13 +787,13 @@ bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::v
     const CBigNum p = params->serialNumberSoKCommitmentGroup.modulus;
     const CBigNum u_inner_prod = params->serialNumberSoKCommitmentGroup.u_inner_prod;
 
-    CBigNum Ptest = CBigNum(1);
+    // Ptest = prod(P_inner^gamma * u_inner^(-z*gamma)) over all the proofs
+    CBN_vector Ptest_bases, Ptest_expos;
 
     std::vector<fBE> forBigExpo;
     CBigNum gamma, x1, u_inner, P_inner;
     CBigNum x, Ak, Bk;
     CBN_vector xlist;
-    CBigNum pt1, pt2;
     CBigNum A, B, z;
     for(unsigned int w=0; w<proofs.size(); w++)
     {
@@ -805,10 +812,11 @@ bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::v
         x1 = CBigNum(hasher.GetHash()) % q;
 
         u_inner = u_inner_prod.pow_mod(x1,p);
-        P_inner = P_inner_prod.mul_mod(u_inner.pow_mod(z,p),p);
 
         // Starting the actual protocol
         xlist.clear();
+        CBN_vector P_bases(1, u_inner);
+        CBN_vector P_expos(1, z);
 
         for(int i=0; i<N1; i++) {
             Ak = dp.signature.innerProduct.pi[0][i];
@@ -820,16 +828,20 @@ bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::v
 
             xlist.push_back(x);
 
-            P_inner = P_inner.mul_mod(
-                    (Ak.pow_mod(x.pow_mod(2,q),p)).mul_mod(Bk.pow_mod(x.pow_mod(-2,q),p),p),p);
+            P_bases.push_back(Ak);
+            P_expos.push_back(x.pow_mod(2,q));
+            P_bases.push_back(Bk);
+            P_expos.push_back(x.pow_mod(-2,q));
         }
 
-        z = dp.signature.innerProduct.final_a[0][0].mul_mod(dp.signature.innerProduct.final_b[0][0],q);
+        P_inner = P_inner_prod.mul_mod(MultiExp(P_bases, P_expos, p),p);
 
-        pt1 = P_inner.pow_mod(gamma,p);
-        pt2 = u_inner.pow_mod(z.mul_mod(-gamma,q),p);
+        z = dp.signature.innerProduct.final_a[0][0].mul_mod(dp.signature.innerProduct.final_b[0][0],q);
 
-        Ptest = Ptest.mul_mod( pt1.mul_mod(pt2,p) ,p);
+        Ptest_bases.push_back(P_inner);
+        Ptest_expos.push_back(gamma);
+        Ptest_bases.push_back(u_inner);
+        Ptest_expos.push_back(z.mul_mod(-gamma,q));
 
         fBE new_element;
         new_element.gamma = gamma;
@@ -844,6 +856,8 @@ bool SerialNumberSoKProof::BatchBulletproofs(const CBN_matrix ck_inner_g, std::v
 
     CBN_vector gh_final = getFinal_gh(params, ck_inner_g[0], forBigExpo);
 
+    CBigNum Ptest = MultiExp(Ptest_bases, Ptest_expos, p);
+
     return (gh_final[0].mul_mod(gh_final[1],p) == Ptest);
 }
 
@@ -896,12 +910,9 @@ CBN_vector SerialNumberSoKProof::getFinal_gh(const ZerocoinParams* ZCp, CBN_vect
         }
     }
 
-    CBN_vector gh_final(2, CBigNum(1));
-
-    for(int i=0; i<n; i++) {
-        gh_final[0] = gh_final[0].mul_mod(gs[i].pow_mod(sg_expo[i],p),p);
-        gh_final[1] = gh_final[1].mul_mod(gs[i].pow_mod(sh_expo[i],p),p);
-    }
+    CBN_vector gh_final(2);
+    gh_final[0] = MultiExp(gs, sg_expo, p);
+    gh_final[1] = MultiExp(gs, sh_expo, p);
 
     return gh_final;
 }
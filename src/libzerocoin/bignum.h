@@ -24,6 +24,7 @@
 #include "uint256.h"
 #include "version.h"
 #include "random.h"
+#include "support/cleanse.h"
 
 /** Errors thrown by the bignum class */
 class bignum_error : public std::runtime_error
@@ -728,19 +729,87 @@ inline std::ostream& operator<<(std::ostream &strm, const CBigNum &b) { return s
 
 #endif
 #if defined(USE_NUM_GMP)
+/**
+ * Per thread pool of cleared mpz_t values. A CBigNum takes its limbs from the pool of the thread that creates it and
+ * hands them back when it is destroyed, so the temporaries of zerocoin arithmetic reuse memory that is already
+ * large enough instead of going through the allocator for every result.
+ */
+class CBigNumPool
+{
+public:
+    /** Most values a thread keeps for reuse */
+    static const size_t MAX_POOLED = 64;
+
+    /** Values with more limbs than this (16384 bits) go back to the allocator */
+    static const int MAX_POOLED_LIMBS = 16384 / GMP_NUMB_BITS;
+
+    explicit CBigNumPool(bool& fDestroyedIn) : fDestroyed(fDestroyedIn)
+    {
+        vFree.reserve(MAX_POOLED);
+    }
+
+    ~CBigNumPool()
+    {
+        for (__mpz_struct& z : vFree)
+            mpz_clear(&z);
+        fDestroyed = true;
+    }
+
+    bool Take(mpz_t z)
+    {
+        if (vFree.empty())
+            return false;
+        *z = vFree.back();
+        vFree.pop_back();
+        return true;
+    }
+
+    /** The limbs must already have been wiped */
+    bool Give(mpz_t z)
+    {
+        if (z->_mp_alloc == 0 || z->_mp_alloc > MAX_POOLED_LIMBS || vFree.size() >= MAX_POOLED)
+            return false;
+        z->_mp_size = 0;
+        vFree.push_back(*z);
+        return true;
+    }
+
+    /** The pool of the calling thread, or nullptr once it has been destroyed at thread exit */
+    static CBigNumPool* Get()
+    {
+        static thread_local bool fDestroyed = false;
+        if (fDestroyed)
+            return nullptr;
+        static thread_local CBigNumPool pool(fDestroyed);
+        return &pool;
+    }
+
+private:
+    std::vector<__mpz_struct> vFree;
+    bool& fDestroyed;
+};
+
 /** C++ wrapper for BIGNUM (Gmp bignum) */
 class CBigNum
 {
     mpz_t bn;
+
+    void init()
+    {
+        CBigNumPool* pool = CBigNumPool::Get();
+        if (!pool || !pool->Take(bn))
+            mpz_init(bn);
+    }
+
 public:
     CBigNum()
     {
-        mpz_init(bn);
+        init();
     }
 
     CBigNum(const CBigNum& b)
     {
-        mpz_init(bn);
+        init();
         mpz_set(bn, b.bn);
     }
 
@@ -752,26 +821,30 @@ public:
 
     ~CBigNum()
     {
-        mpz_clear(bn);
+        // Wipe the limbs like BN_clear_free does, since they may have held a coin secret
+        memory_cleanse(bn->_mp_d, bn->_mp_alloc * sizeof(mp_limb_t));
+        CBigNumPool* pool = CBigNumPool::Get();
+        if (!pool || !pool->Give(bn))
+            mpz_clear(bn);
     }
 
     //CBigNum(char n) is not portable.  Use 'signed char' or 'unsigned char'.
-    CBigNum(signed char n)      { mpz_init(bn); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
-    CBigNum(short n)            { mpz_init(bn); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
-    CBigNum(int n)              { mpz_init(bn); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
-    CBigNum(long n)             { mpz_init(bn); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
-    CBigNum(long long n)        { mpz_init(bn); mpz_set_si(bn, n); }
-    CBigNum(unsigned char n)    { mpz_init(bn); mpz_set_ui(bn, n); }
-    CBigNum(unsigned short n)   { mpz_init(bn); mpz_set_ui(bn, n); }
-    CBigNum(unsigned int n)     { mpz_init(bn); mpz_set_ui(bn, n); }
-    CBigNum(unsigned long n)    { mpz_init(bn); mpz_set_ui(bn, n); }
-
-    explicit CBigNum(uint256 n) { mpz_init(bn); setuint256(n); }
-    explicit CBigNum(arith_uint256 n) { mpz_init(bn); setarith_256(n); }
+    CBigNum(signed char n)      { init(); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
+    CBigNum(short n)            { init(); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
+    CBigNum(int n)              { init(); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
+    CBigNum(long n)             { init(); if (n >= 0) mpz_set_ui(bn, n); else mpz_set_si(bn, n); }
+    CBigNum(long long n)        { init(); mpz_set_si(bn, n); }
+    CBigNum(unsigned char n)    { init(); mpz_set_ui(bn, n); }
+    CBigNum(unsigned short n)   { init(); mpz_set_ui(bn, n); }
+    CBigNum(unsigned int n)     { init(); mpz_set_ui(bn, n); }
+    CBigNum(unsigned long n)    { init(); mpz_set_ui(bn, n); }
+
+    explicit CBigNum(uint256 n) { init(); setuint256(n); }
+    explicit CBigNum(arith_uint256 n) { init(); setarith_256(n); }
 
     explicit CBigNum(const std::vector<unsigned char>& vch)
     {
-        mpz_init(bn);
+        init();
         setvch(vch);
     }
 
@@ -835,7 +908,7 @@ public:
     int getint() const
     {
         unsigned long n = getulong();
-        if (mpz_cmp(bn, CBigNum(0).bn) >= 0) {
+        if (mpz_sgn(bn) >= 0) {
             return (n > (unsigned long)std::numeric_limits<int>::max() ? std::numeric_limits<int>::max() : n);
         } else {
             return (n > (unsigned long)std::numeric_limits<int>::max() ? std::numeric_limits<int>::min() : -(int)n);
@@ -883,7 +956,7 @@ public:
 
     std::vector<unsigned char> getvch() const
     {
-        if (mpz_cmp(bn, CBigNum(0).bn) == 0) {
+        if (mpz_sgn(bn) == 0) {
             return std::vector<unsigned char>(0);
         }
         size_t size = (mpz_sizeinbase (bn, 2) + CHAR_BIT-1) / CHAR_BIT;
@@ -1000,7 +1073,7 @@ public:
      */
     CBigNum pow_mod(const CBigNum& e, const CBigNum& m) const {
         CBigNum ret;
-        if (e > CBigNum(0) && mpz_odd_p(m.bn))
+        if (mpz_sgn(e.bn) > 0 && mpz_odd_p(m.bn))
             mpz_powm_sec (ret.bn, bn, e.bn, m.bn);
         else
             mpz_powm (ret.bn, bn, e.bn, m.bn);
@@ -1056,12 +1129,12 @@ public:
 
     bool isOne() const
     {
-        return mpz_cmp(bn, CBigNum(1).bn) == 0;
+        return mpz_cmp_ui(bn, 1) == 0;
     }
 
     bool operator!() const
     {
-        return mpz_cmp(bn, CBigNum(0).bn) == 0;
+        return mpz_sgn(bn) == 0;
     }
 
     CBigNum& operator+=(const CBigNum& b)
@@ -1110,7 +1183,7 @@ public:
     CBigNum& operator++()
     {
         // prefix operator
-        mpz_add(bn, bn, CBigNum(1).bn);
+        mpz_add_ui(bn, bn, 1);
         return *this;
     }
 
@@ -1125,7 +1198,7 @@ public:
     CBigNum& operator--()
     {
         // prefix operator
-        mpz_sub(bn, bn, CBigNum(1).bn);
+        mpz_sub_ui(bn, bn, 1);
         return *this;
     }
 
@@ -11,6 +11,8 @@
 **/
 #pragma once
 
+#include "MultiExp.h"
+
 namespace libzerocoin {
 
 
@@ -84,6 +86,8 @@ inline CBigNum pedersenCommitment(const ZerocoinParams* ZCparams,
     if( SoKgroup->gis.size() < g_blinders.size() )
         throw std::runtime_error("len(gelements) < len(g_blinders) in pedersenCommit");
 
+    // The blinders are the prover's secrets, so every generator uses the constant time pow_mod rather than the
+    // fixed-base tables or MultiExp
     CBigNum C = CBigNum(1);
     for(unsigned int i=0; i<g_blinders.size(); i++)
         C = C.mul_mod((SoKgroup->gis[i]).pow_mod(g_blinders[i],p),p);
@@ -120,6 +120,7 @@ const CLogCategoryDesc LogCategories[] =
     {BCLog::QT, "qt"},
     {BCLog::LEVELDB, "leveldb"},
     {BCLog::ZEROCOINDB, "zerocoindb"},
+    {BCLog::X16R, "x16r"},
     {BCLog::ALL, "1"},
     {BCLog::ALL, "all"},
 };
@@ -13,6 +13,7 @@
 #include <consensus/tx_verify.h>
 #include <consensus/merkle.h>
 #include <consensus/validation.h>
+#include <crypto/x16r/x16r_4way.h>
 #include <hash.h>
 #include <net.h>
 #include <policy/feerate.h>
@@ -33,6 +34,10 @@
 #include <veil/zerocoin/zchain.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
 #include <queue>
 #include <utility>
 #include <boost/thread.hpp>
@@ -343,7 +348,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
             LogPrintf("%s: failed to get accumulator checkpoints\n", __func__);
         pblock->mapAccumulatorHashes = mapAccumulators.GetCheckpoints(true);
     } else {
-        pblock->mapAccumulatorHashes = pindexPrev->mapAccumulatorHashes;
+        pblock->mapAccumulatorHashes = pindexPrev->GetAccumulatorHashes().ToMap();
     }
 
     //Proof of full node
@@ -675,118 +680,247 @@ bool fGenerateBitcoins = false;
 bool fMintableCoins = false;
 int nMintableLastCheck = 0;
 
-CCriticalSection cs_nonce;
-static int32_t nNonce_base = 0;
-static arith_uint256 nHashes = 0;
-static int32_t nTimeStart = 0;
-
-void BitcoinMiner(std::shared_ptr<CReserveScript> coinbaseScript, bool fProofOfStake = false, bool fProofOfFullNode = false) {
+/** Stake blocks with the main wallet. Proof of work blocks are mined by ThreadPoWTemplate and ThreadPoWHash. */
+void static BitcoinMiner(std::shared_ptr<CReserveScript> coinbaseScript, bool fProofOfFullNode) {
     LogPrintf("Veil Miner started\n");
 
-    unsigned int nExtraNonce = 0;
-    static const int nInnerLoopCount = 0x010000;
-
-    while (fGenerateBitcoins || fProofOfStake)
+    while (true)
     {
         boost::this_thread::interruption_point();
-        if (fProofOfStake) {
-            //Need wallet if this is for proof of stake
-            auto pwallet = GetMainWallet();
-            if (!pwallet || !g_connman->GetNodeCount(CConnman::NumConnections::CONNECTIONS_ALL) || !pwallet->IsStakingEnabled()) {
-                MilliSleep(5000);
-                continue;
-            }
+        //Need wallet for proof of stake
+        auto pwallet = GetMainWallet();
+        if (!pwallet || !g_connman->GetNodeCount(CConnman::NumConnections::CONNECTIONS_ALL) || !pwallet->IsStakingEnabled()) {
+            MilliSleep(5000);
+            continue;
+        }
 
-            //control the amount of times the client will check for mintable coins
-            if ((GetTime() - nMintableLastCheck > 5 * 60)) // 5 minute check time
-            {
-                nMintableLastCheck = GetTime();
-                fMintableCoins = pwallet->MintableCoins();
-            }
+        //control the amount of times the client will check for mintable coins
+        if ((GetTime() - nMintableLastCheck > 5 * 60)) // 5 minute check time
+        {
+            nMintableLastCheck = GetTime();
+            fMintableCoins = pwallet->MintableCoins();
+        }
 
-            while ((pwallet->IsLocked() && !pwallet->IsUnlockedForStakingOnly()) || !fMintableCoins || IsInitialBlockDownload()) {
-                // Do a separate 1 minute check here to ensure fMintableCoins is updated
-                if (!fMintableCoins) {
-                    if (GetTime() - nMintableLastCheck > 1 * 60) // 1 minute check time
-                    {
-                        nMintableLastCheck = GetTime();
-                        fMintableCoins = pwallet->MintableCoins();
-                    }
+        while ((pwallet->IsLocked() && !pwallet->IsUnlockedForStakingOnly()) || !fMintableCoins || IsInitialBlockDownload()) {
+            // Do a separate 1 minute check here to ensure fMintableCoins is updated
+            if (!fMintableCoins) {
+                if (GetTime() - nMintableLastCheck > 1 * 60) // 1 minute check time
+                {
+                    nMintableLastCheck = GetTime();
+                    fMintableCoins = pwallet->MintableCoins();
                 }
-                MilliSleep(5000);
-                if (!fGenerateBitcoins && !fProofOfStake)
-                    continue;
             }
+            MilliSleep(5000);
+        }
 
-            //search our map of hashed blocks, see if bestblock has been hashed yet
-            if (mapHashedBlocks.count(chainActive.Tip()->nHeight)) {
-                // wait half of the nHashDrift with max wait of 3 minutes
-                if (GetTime() - mapHashedBlocks[chainActive.Tip()->nHeight] < max(60, 1)) {
-                    MilliSleep(5000);
-                    continue;
-                }
+        //search our map of hashed blocks, see if bestblock has been hashed yet
+        if (mapHashedBlocks.count(chainActive.Tip()->nHeight)) {
+            // wait half of the nHashDrift with max wait of 3 minutes
+            if (GetTime() - mapHashedBlocks[chainActive.Tip()->nHeight] < max(60, 1)) {
+                MilliSleep(5000);
+                continue;
             }
         }
 
         CScript scriptMining;
         if (coinbaseScript)
             scriptMining = coinbaseScript->reserveScript;
-        std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(scriptMining, false, fProofOfStake, fProofOfFullNode));
+        std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(scriptMining, false, true, fProofOfFullNode));
         if (!pblocktemplate || !pblocktemplate.get())
             continue;
 
         CBlock *pblock = &pblocktemplate->block;
-        int32_t nNonceLocal;
 
-        if (!fProofOfStake)
+        std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
+        if (!ProcessNewBlock(Params(), shared_pblock, true, nullptr)) {
+            LogPrintf("%s : Failed to process new block, clearing mempool txs\n", __func__);
+            mempool.clear();
+            continue;
+        }
+    }
+}
+
+/** Number of nonces a PoW hashing thread claims from the shared job at a time */
+static const uint64_t POW_NONCE_RANGE = 0x10000;
+/** Seconds after which the template thread rebuilds the PoW template to pick up new transactions */
+static const int64_t POW_TEMPLATE_REFRESH = 60;
+/** Milliseconds between updates of the reported PoW hash rate */
+static const int64_t POW_HASHRATE_INTERVAL = 5000;
+
+/**
+ * Block template shared by the PoW mining threads. ThreadPoWTemplate publishes a new job when the tip changes,
+ * the template gets old or its nonces run out; the ThreadPoWHash threads claim disjoint nonce ranges from it.
+ */
+struct CPoWMiningJob
+{
+    CBlock block;
+    //! X16R algorithm order, fixed for the whole job as nTime is
+    uint256 hashSelector;
+    std::shared_ptr<CReserveScript> coinbaseScript;
+    std::atomic<uint64_t> nNextNonce;
+    std::atomic<bool> fSolved;
+    //! Set when a newer job replaces this one or it is solved, hashing threads move on
+    std::atomic<bool> fStale;
+
+    CPoWMiningJob() : nNextNonce(0), fSolved(false), fStale(false) {}
+};
+
+static std::mutex cs_powjob;
+static std::condition_variable cv_powjob;
+static std::shared_ptr<CPoWMiningJob> pPoWJob;
+static std::atomic<uint64_t> nPoWHashes(0);
+static std::atomic<double> dPoWHashRate(0);
+
+double GetPoWHashRate()
+{
+    return dPoWHashRate;
+}
+
+static void PublishPoWJob(const std::shared_ptr<CPoWMiningJob>& pjob)
+{
+    std::lock_guard<std::mutex> lock(cs_powjob);
+    if (pPoWJob)
+        pPoWJob->fStale = true;
+    pPoWJob = pjob;
+    cv_powjob.notify_all();
+}
+
+/** Wait a little for a job other than pjobLast, returns the current job either way */
+static std::shared_ptr<CPoWMiningJob> WaitForPoWJob(const std::shared_ptr<CPoWMiningJob>& pjobLast)
+{
+    std::unique_lock<std::mutex> lock(cs_powjob);
+    cv_powjob.wait_for(lock, std::chrono::milliseconds(500), [&pjobLast] { return pPoWJob && pPoWJob != pjobLast; });
+    return pPoWJob;
+}
+
+static void SubmitPoWBlock(const std::shared_ptr<CPoWMiningJob>& pjob, uint32_t nNonce)
+{
+    // Only the first thread to solve the job submits it
+    bool fExpected = false;
+    if (!pjob->fSolved.compare_exchange_strong(fExpected, true))
+        return;
+    pjob->fStale = true;
+
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>(pjob->block);
+    pblock->nNonce = nNonce;
+    if (!ProcessNewBlock(Params(), pblock, true, nullptr)) {
+        LogPrintf("%s : Failed to process new block, clearing mempool txs\n", __func__);
+        mempool.clear();
+        return;
+    }
+
+    if (pjob->coinbaseScript)
+        pjob->coinbaseScript->KeepScript();
+}
+
+void static ThreadPoWTemplate(std::shared_ptr<CReserveScript> coinbaseScript)
+{
+    LogPrintf("%s started\n", __func__);
+    unsigned int nExtraNonce = 0;
+    int64_t nRateStart = GetTimeMillis();
+    uint64_t nRateHashes = nPoWHashes;
+
+    while (fGenerateBitcoins) {
+        boost::this_thread::interruption_point();
+        CScript scriptMining;
+        if (coinbaseScript)
+            scriptMining = coinbaseScript->reserveScript;
+        std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(scriptMining, false));
+        if (!pblocktemplate) {
+            MilliSleep(1000);
+            continue;
+        }
+
+        std::shared_ptr<CPoWMiningJob> pjob = std::make_shared<CPoWMiningJob>();
+        pjob->block = pblocktemplate->block;
         {
-            {
-                LOCK(cs_nonce);
-                nNonceLocal = nNonce_base++;
-                if (!nTimeStart)
-                    nTimeStart = GetTime();
+            LOCK(cs_main);
+            IncrementExtraNonce(&pjob->block, chainActive.Tip(), nExtraNonce);
+        }
+        pjob->block.nNonce = 0;
+        pjob->hashSelector = GetX16RSelector(pjob->block.nTime);
+        pjob->coinbaseScript = coinbaseScript;
+        PublishPoWJob(pjob);
+
+        int64_t nJobStart = GetTime();
+        while (!pjob->fStale) {
+            MilliSleep(250);
+
+            int64_t nNow = GetTimeMillis();
+            if (nNow - nRateStart >= POW_HASHRATE_INTERVAL) {
+                uint64_t nHashes = nPoWHashes;
+                dPoWHashRate = (nHashes - nRateHashes) * 1000.0 / (nNow - nRateStart);
+                nRateHashes = nHashes;
+                nRateStart = nNow;
             }
 
-            pblock->nNonce = 0;
             {
                 LOCK(cs_main);
-                nExtraNonce = nNonceLocal;
-                IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
+                if (chainActive.Tip()->GetBlockHash() != pjob->block.hashPrevBlock)
+                    break;
             }
+            if (GetTime() - nJobStart >= POW_TEMPLATE_REFRESH)
+                break;
+            if (pjob->nNextNonce > std::numeric_limits<uint32_t>::max())
+                break;
+        }
+    }
+}
 
-            int nTries = 0;
-            while (nTries < nInnerLoopCount && !CheckProofOfWork(pblock->GetPoWHash(), pblock->nBits, Params().GetConsensus())) {
-                boost::this_thread::interruption_point();
-                ++nTries;
-                ++pblock->nNonce;
-            }
+void static ThreadPoWHash()
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    std::shared_ptr<CPoWMiningJob> pjob;
 
-            LOCK(cs_nonce);
-            nHashes += nTries;
-            int32_t nTimeDuration = GetTime() - nTimeStart;
-            LogPrintf("%s: PoW Hashspeed %d kh/s\n", __func__, arith_uint256(nHashes/1000/nTimeDuration).getdouble());
-            if (nTries == nInnerLoopCount) {
+    while (fGenerateBitcoins) {
+        boost::this_thread::interruption_point();
+        if (!pjob || pjob->fStale) {
+            pjob = WaitForPoWJob(pjob);
+            if (!pjob || pjob->fStale)
                 continue;
-            }
         }
 
-        std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
-        if (!ProcessNewBlock(Params(), shared_pblock, true, nullptr)) {
-            LogPrintf("%s : Failed to process new block, clearing mempool txs\n", __func__);
-            mempool.clear();
+        uint64_t nStart = pjob->nNextNonce.fetch_add(POW_NONCE_RANGE);
+        if (nStart > std::numeric_limits<uint32_t>::max()) {
+            // Out of nonces, the template thread will publish a job with a new extra nonce
+            pjob = WaitForPoWJob(pjob);
             continue;
         }
 
-        if (!fProofOfStake)
-            coinbaseScript->KeepScript();
+        // Hash consecutive nonces side by side on the multi-buffer X16R primitives. Only the nonce
+        // changes between lanes, the algorithm order of the job was computed once by the template thread.
+        std::vector<CBlockHeader> vLanes(X16R_4WAY_LANES, pjob->block.GetBlockHeader());
+        std::vector<const unsigned char*> vInputs;
+        for (const CBlockHeader& lane : vLanes)
+            vInputs.push_back((const unsigned char*)BEGIN(lane.nVersion));
+        std::vector<uint256> vSelectors(vLanes.size(), pjob->hashSelector);
+        std::vector<uint256> vHashes(vLanes.size());
+        size_t nLen = END(vLanes[0].nNonce) - BEGIN(vLanes[0].nVersion);
+
+        for (uint64_t nNonce = nStart; nNonce < nStart + POW_NONCE_RANGE && !pjob->fStale; nNonce += vLanes.size()) {
+            boost::this_thread::interruption_point();
+            for (size_t i = 0; i < vLanes.size(); i++)
+                vLanes[i].nNonce = nNonce + i;
+            HashX16RMulti(vInputs.data(), nLen, vSelectors.data(), vHashes.data(), vLanes.size());
+            nPoWHashes += vLanes.size();
+            for (size_t i = 0; i < vHashes.size(); i++) {
+                if (CheckProofOfWork(vHashes[i], pjob->block.nBits, consensusParams)) {
+                    SubmitPoWBlock(pjob, vLanes[i].nNonce);
+                    break;
+                }
+            }
+        }
     }
 }
 
-void static ThreadBitcoinMiner(std::shared_ptr<CReserveScript> coinbaseScript)
+void static ThreadBitcoinMiner(std::shared_ptr<CReserveScript> coinbaseScript, bool fTemplate)
 {
     boost::this_thread::interruption_point();
     try {
-        BitcoinMiner(coinbaseScript);
+        if (fTemplate)
+            ThreadPoWTemplate(coinbaseScript);
+        else
+            ThreadPoWHash();
         boost::this_thread::interruption_point();
     } catch (std::exception& e) {
         LogPrintf("ThreadBitcoinMiner() exception\n");
@@ -807,7 +941,7 @@ void ThreadStakeMiner()
         try {
             std::shared_ptr<CReserveScript> coinbase_script;
             bool fProofOfFullNode = true;
-            BitcoinMiner(coinbase_script, true, fProofOfFullNode);
+            BitcoinMiner(coinbase_script, fProofOfFullNode);
             boost::this_thread::interruption_point();
         } catch (std::exception& e) {
             LogPrintf("ThreadStakeMiner() exception\n");
@@ -843,10 +977,15 @@ void GenerateBitcoins(bool fGenerate, int nThreads, std::shared_ptr<CReserveScri
         pthreadGroupPoW->interrupt_all();
         pthreadGroupPoW->join_all();
     }
+    PublishPoWJob(nullptr);
+    dPoWHashRate = 0;
 
     if (nThreads == 0 || !fGenerate)
         return;
+
+    // One thread keeps the shared template current, the others only hash
+    pthreadGroupPoW->create_thread(boost::bind(&ThreadBitcoinMiner, coinbaseScript, true));
     for (int i = 0; i < nThreads; i++)
-        pthreadGroupPoW->create_thread(boost::bind(&ThreadBitcoinMiner, coinbaseScript));
+        pthreadGroupPoW->create_thread(boost::bind(&ThreadBitcoinMiner, coinbaseScript, false));
 
 }
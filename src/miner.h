@@ -197,6 +197,8 @@ private:
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlock* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 void GenerateBitcoins(bool fGenerate, int nThreads, std::shared_ptr<CReserveScript> coinbaseScript);
+/** Hashes per second of the internal PoW miner, 0 when it is not running */
+double GetPoWHashRate();
 void ThreadStakeMiner();
 void LinkPoWThreadGroup(void* pthreadgroup);
 
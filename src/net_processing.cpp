@@ -9,6 +9,7 @@
 #include <arith_uint256.h>
 #include <blockencodings.h>
 #include <chainparams.h>
+#include <checkqueue.h>
 #include <consensus/validation.h>
 #include <hash.h>
 #include <validation.h>
@@ -76,7 +77,7 @@ struct COrphanTx {
 };
 static CCriticalSection g_cs_orphans;
 std::map<uint256, COrphanTx> mapOrphanTransactions GUARDED_BY(g_cs_orphans);
-std::map<int, CBlock> mapStagedBlocks;
+std::map<int, std::shared_ptr<CBlock>> mapStagedBlocks;
 static int nStagedCacheSize = 0;
 static constexpr int STAGING_CACHE_SIZE = 1000000 * 100; //100mb cache
 static constexpr int ASK_FOR_BLOCKS = 50; //How many blocks to ask for at once
@@ -598,7 +599,7 @@ static void FindNextBlocksToDownload(NodeId nodeid, unsigned int count, std::vec
             if (pindex->nHeight != nBestHeight + 1) {
                 LOCK(cs_staging);
                 if (mapStagedBlocks.count(pindex->nHeight)) {
-                    if (mapStagedBlocks.at(pindex->nHeight).GetHash() == pindex->GetBlockHash())
+                    if (mapStagedBlocks.at(pindex->nHeight)->GetHash() == pindex->GetBlockHash())
                         continue;
                 }
             }
@@ -1399,30 +1400,97 @@ inline void static SendBlockTransactions(const CBlock& block, const BlockTransac
     connman->PushMessage(pfrom, msgMaker.Make(nSendFlags, NetMsgType::BLOCKTXN, resp));
 }
 
-bool GetZerocoinSpendProofs(const CTxIn &txin, std::vector<libzerocoin::SerialNumberSoKProof> &proofsOut)
+/** A zerocoin spend of a staged block, with the value of the accumulator it proves membership of */
+struct CStagedSpend
 {
-    auto newSpend = TxInToZerocoinSpend(txin);
-    //see if we have record of the accumulator used in the spend tx
-    CBigNum bnAccumulatorValue = 0;
+    std::shared_ptr<libzerocoin::CoinSpend> spend;
+    CBigNum bnAccumulatorValue;
+};
+
+/** Staged blocks whose zerocoin spends are verified together by one CStagedSpendCheck */
+struct CStagedSpendBatch
+{
+    std::vector<std::shared_ptr<CBlock>> vBlocks;
+    std::vector<CStagedSpend> vSpends;
+};
+
+/**
+ * Closure verifying all three proofs of every spend in a batch: the commitment and accumulator proofs one by one,
+ * and the serial number signatures of knowledge in one batch verification. The blocks of the batch are marked
+ * as having verified signatures once it passes. A batch that fails leaves its blocks to be fully checked when
+ * they are connected, so it always succeeds as far as the queue is concerned.
+ */
+class CStagedSpendCheck
+{
+private:
+    CStagedSpendBatch* pbatch;
+
+public:
+    CStagedSpendCheck() : pbatch(nullptr) {}
+    explicit CStagedSpendCheck(CStagedSpendBatch* pbatchIn) : pbatch(pbatchIn) {}
+
+    bool operator()()
     {
-        LOCK(cs_main);
-        if (!pzerocoinDB->ReadAccumulatorValue(newSpend->getAccumulatorChecksum(), bnAccumulatorValue))
-            return false;
-    }
+        std::vector<libzerocoin::SerialNumberSoKProof> vProofs;
+        for (const CStagedSpend& staged : pbatch->vSpends) {
+            libzerocoin::Accumulator accumulator(Params().Zerocoin_Params(), staged.spend->getDenomination(), staged.bnAccumulatorValue);
 
-    libzerocoin::Accumulator accumulator(Params().Zerocoin_Params(), newSpend->getDenomination(), bnAccumulatorValue);
+            //Check that the coin has been accumulated
+            std::string strError;
+            if (!staged.spend->Verify(accumulator, strError, false)) {
+                LogPrintf("%s: Zerocoinspend could not verify. Details: %s\n", __func__, strError);
+                return true;
+            }
 
-    //Check that the coin has been accumulated
-    std::string strError;
-    if (!newSpend->Verify(accumulator, strError, false)) {
-        LogPrintf("%s: Zerocoinspend could not verify. Details: %s\n", __func__, strError);
-        return false;
+            vProofs.emplace_back(staged.spend->getSmallSoK(), staged.spend->getCoinSerialNumber(),
+                                 staged.spend->getSerialComm(), staged.spend->getHashSig());
+        }
+
+        if (!vProofs.empty() && !libzerocoin::SerialNumberSoKProof::BatchVerify(vProofs))
+            return true;
+
+        for (const std::shared_ptr<CBlock>& pblock : pbatch->vBlocks)
+            pblock->fSignaturesVerified = true;
+        return true;
     }
 
-    libzerocoin::SerialNumberSoKProof proof(newSpend->getSmallSoK(), newSpend->getCoinSerialNumber(),
-                               newSpend->getSerialComm(), newSpend->getHashSig());
-    proofsOut.push_back(proof);
+    void swap(CStagedSpendCheck& check)
+    {
+        std::swap(pbatch, check.pbatch);
+    }
+};
+
+static CCheckQueue<CStagedSpendCheck> stagedspendcheckqueue(1);
+
+void ThreadStagedSpendCheck() {
+    RenameThread("veil-stagedspend");
+    stagedspendcheckqueue.Thread();
+}
+
+/**
+ * Collect the zerocoin spends of a staged block, false if any of them cannot be verified ahead of connecting the
+ * block: it cannot be decoded, repeats a serial of another staged spend or uses an unknown accumulator checkpoint.
+ */
+static bool GetStagedSpends(const CBlock& block, std::set<CBigNum>& setSerials, std::vector<CStagedSpend>& vSpends)
+{
+    LOCK(cs_main);
+    for (const auto& tx : block.vtx) {
+        if (!tx->IsZerocoinSpend())
+            continue;
+
+        for (const auto& txin : tx->vin) {
+            CStagedSpend staged;
+            staged.spend = TxInToZerocoinSpend(txin);
+            if (!staged.spend || !setSerials.emplace(staged.spend->getCoinSerialNumber()).second)
+                return false;
+
+            //see if we have record of the accumulator used in the spend tx
+            if (!pzerocoinDB->ReadAccumulatorValue(staged.spend->getAccumulatorChecksum(), staged.bnAccumulatorValue))
+                return false;
 
+            vSpends.emplace_back(std::move(staged));
+        }
+    }
     return true;
 }
 
@@ -1460,7 +1528,7 @@ void ProcessStaging()
             nHeightNext = chainActive.Height() + 1;
         }
 
-        std::map<int, CBlock> mapStagedBlocksCopy;
+        std::vector<std::pair<int, std::shared_ptr<CBlock>>> vStagedBlocks;
         {
             LOCK(cs_staging);
             if (mapStagedBlocks.empty()) {
@@ -1468,74 +1536,55 @@ void ProcessStaging()
                 continue;
             }
 
-            mapStagedBlocksCopy = mapStagedBlocks;
+            vStagedBlocks.assign(mapStagedBlocks.begin(), mapStagedBlocks.end());
         }
 
-        // Perform batch verification for all staged blocks (that haven't yet been verified) to speed up getting blocks
-        std::vector<CBigNum> vBlockSerials;
-        std::vector<libzerocoin::SerialNumberSoKProof> vProofs;
-        std::set<int> setRemoveBlocks;
+        // Split the spends of the staged blocks (that haven't yet been verified) into a batch per staged spend
+        // check thread, keeping each block in a single batch, to speed up getting blocks
+        std::vector<CStagedSpendBatch> vBatches(std::max(std::min(nScriptCheckThreads, MAX_STAGEDSPENDCHECK_THREADS), 1));
+        std::set<CBigNum> setSerials;
+        size_t nSpends = 0;
         int nBestHeight = nHeightNext -1;
         int nHaveCheckpointHeight = 10 - (nBestHeight % 10) + nBestHeight;
-        for (auto &blockPair : mapStagedBlocksCopy) {
+        for (const auto& blockPair : vStagedBlocks) {
             // Likely do not have the accumulator checkpoint so cannot verify
-            if (blockPair.first > nHaveCheckpointHeight) {
-                setRemoveBlocks.insert(blockPair.first);
+            if (blockPair.first > nHaveCheckpointHeight)
                 continue;
-            }
             // Signatures for this block have already been verified, skip
-            if (blockPair.second.fSignaturesVerified)
+            if (blockPair.second->fSignaturesVerified)
                 continue;
 
-            bool fSkipBlock = false;
-            std::vector<libzerocoin::SerialNumberSoKProof> vProofsTemp;
-
-            for (auto &tx : blockPair.second.vtx) {
-                if (tx->IsZerocoinSpend()) {
-                    for (auto &txin : tx->vin) {
-                        libzerocoin::CoinSpend spend = *(TxInToZerocoinSpend(txin));
-                        if (!GetZerocoinSpendProofs(txin, vProofsTemp) || count(vBlockSerials.begin(),
-                                vBlockSerials.end(), spend.getCoinSerialNumber())) {
-                            setRemoveBlocks.insert(blockPair.first);
-                            fSkipBlock = true;
-                            break;
-                        }
-
-                        vBlockSerials.emplace_back(spend.getCoinSerialNumber());
-                    }
-                }
-
-                if (fSkipBlock)
-                    break;
-            }
-
-            // If no problems were encountered when getting the zerocoin spend proofs, add to proofs to verify
-            if (!fSkipBlock) {
-                vProofs.insert(vProofs.end(), vProofsTemp.begin(), vProofsTemp.end());
-            }
-        }
-
-        for (auto blockHeight : setRemoveBlocks) {
-            mapStagedBlocksCopy.erase(blockHeight);
-        }
+            std::vector<CStagedSpend> vSpends;
+            if (!GetStagedSpends(*blockPair.second, setSerials, vSpends))
+                continue;
 
-        // Now verify the batched spends
-        bool fVerificationSuccess = true;
-        // Probably not worth verifying if it is only one proof
-        if (vProofs.size() > 1) {
-            LogPrintf("%s: Batch verifying %d zeroknowledge proofs\n", __func__, vProofs.size());
-            if(!libzerocoin::SerialNumberSoKProof::BatchVerify(vProofs)) {
-                fVerificationSuccess = false;
+            if (vSpends.empty()) {
+                blockPair.second->fSignaturesVerified = true;
+                continue;
             }
-        }
 
-        if (fVerificationSuccess) {
-            LOCK(cs_staging);
-            for (auto &blockPair : mapStagedBlocksCopy) {
-                if (!mapStagedBlocks.count(blockPair.first))
-                    continue;
-
-                mapStagedBlocks[blockPair.first].fSignaturesVerified = true;
+            auto itBatch = std::min_element(vBatches.begin(), vBatches.end(),
+                    [](const CStagedSpendBatch& a, const CStagedSpendBatch& b) { return a.vSpends.size() < b.vSpends.size(); });
+            itBatch->vBlocks.emplace_back(blockPair.second);
+            std::move(vSpends.begin(), vSpends.end(), std::back_inserter(itBatch->vSpends));
+            nSpends += vSpends.size();
+        }
+
+        // Now verify the batches, each on its own thread
+        std::vector<CStagedSpendCheck> vChecks;
+        for (CStagedSpendBatch& batch : vBatches) {
+            if (!batch.vSpends.empty())
+                vChecks.emplace_back(&batch);
+        }
+        if (!vChecks.empty()) {
+            LogPrintf("%s: Verifying %d zerocoin spends in %d batches\n", __func__, nSpends, vChecks.size());
+            if (nScriptCheckThreads && vChecks.size() > 1) {
+                CCheckQueueControl<CStagedSpendCheck> control(&stagedspendcheckqueue);
+                control.Add(vChecks);
+                control.Wait();
+            } else {
+                for (CStagedSpendCheck& check : vChecks)
+                    check();
             }
         }
 
@@ -1550,13 +1599,12 @@ void ProcessStaging()
                     nHeightNext++;
             }
 
-            std::shared_ptr<CBlock> pblockStaged = std::make_shared<CBlock>();
+            std::shared_ptr<CBlock> pblockStaged;
             {
                 LOCK(cs_staging);
                 if (!mapStagedBlocks.count(nHeightNext))
                     break;
-                CBlock blockStaged = mapStagedBlocks.at(nHeightNext);
-                *pblockStaged = blockStaged;
+                pblockStaged = mapStagedBlocks.at(nHeightNext);
             }
 
             bool fProcessNext;
@@ -1571,7 +1619,10 @@ void ProcessStaging()
             bool fNewBlock = false;
             if (!ProcessNewBlock(Params(), pblockStaged, true, &fNewBlock))
                 error("Staging thread failed to process block\n");
-            mapStagedBlocks.erase(nHeightNext);
+            {
+                LOCK(cs_staging);
+                mapStagedBlocks.erase(nHeightNext);
+            }
 
             // If there is a new accumulator checkpoint, jump out so that we can try the next round  of batch zkproof batch verification
             if (nHeightNext % 10 == 0)
@@ -2494,10 +2545,22 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         CInv inv(MSG_TX, tx.GetHash(), nTimeStemPhase);
         pfrom->AddInventoryKnown(inv);
 
+        // Veil: verify zerocoin spend proofs before taking cs_main, AcceptToMemoryPool then finds them in the spend cache.
+        // Spends that are already known or were rejected are not verified again.
+        CValidationState state;
+        bool fZerocoinSpendChecked = true;
+        if (tx.IsZerocoinSpend()) {
+            bool fAlreadyHave;
+            {
+                LOCK(cs_main);
+                fAlreadyHave = AlreadyHave(inv);
+            }
+            fZerocoinSpendChecked = !fAlreadyHave && PreVerifyZerocoinSpends(tx, state);
+        }
+
         LOCK2(cs_main, g_cs_orphans);
 
         bool fMissingInputs = false;
-        CValidationState state;
 
         pfrom->setAskFor.erase(inv.hash);
         mapAlreadyAskedFor.erase(inv.hash);
@@ -2587,7 +2650,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
             for (uint256 hash : vEraseQueue)
                 EraseOrphanTx(hash);
         }
-        else if (tx.IsZerocoinSpend() && AcceptToMemoryPool(mempool, state, ptx, &fMissingInputs, &lRemovedTxn, false, 0)) {
+        else if (tx.IsZerocoinSpend() && fZerocoinSpendChecked && AcceptToMemoryPool(mempool, state, ptx, &fMissingInputs, &lRemovedTxn, false, 0)) {
             RelayTransaction(tx, connman);
         }
         else if (fMissingInputs)
@@ -3041,7 +3104,7 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
                     if (nStagedCacheSize < STAGING_CACHE_SIZE) {
                         LOCK(cs_staging);
                         nStagedCacheSize += nSizeBlock;
-                        mapStagedBlocks.emplace(pindexPrev->nHeight+1, *pblock);
+                        mapStagedBlocks.emplace(pindexPrev->nHeight+1, pblock);
                         LogPrint(BCLog::NET, "staging block %s (%d) because only have prevheader and not prev block\n",
                                  pblock->GetHash().ToString(), pindexPrev->nHeight+1);
                     } else {
@@ -16,6 +16,8 @@ static const unsigned int DEFAULT_MAX_ORPHAN_TRANSACTIONS = 100;
 static const unsigned int DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN = 100;
 /** Default for BIP61 (sending reject messages) */
 static constexpr bool DEFAULT_ENABLE_BIP61 = true;
+/** Staged zerocoin spends are only verified when staging, so at most this many threads are used for them */
+static const int MAX_STAGEDSPENDCHECK_THREADS = 2;
 
 class PeerLogicValidation final : public CValidationInterface, public NetEventsInterface {
 private:
@@ -85,5 +87,7 @@ struct CNodeStateStats {
 bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats);
 void ProcessStaging();
 void ThreadStaging();
+/** Run an instance of the staged zerocoin spend verification thread */
+void ThreadStagedSpendCheck();
 
 #endif // BITCOIN_NET_PROCESSING_H
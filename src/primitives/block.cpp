@@ -17,14 +17,40 @@ uint256 CBlockHeader::GetHash() const
 }
 
 #define TIME_MASK 0xffffff80
-uint256 CBlockHeader::GetPoWHash() const
+uint256 GetX16RSelector(uint32_t nTime)
 {
     //Only change every 128 seconds
     int32_t nTimeX16r = nTime&TIME_MASK;
-    uint256 hashTime = Hash(BEGIN(nTimeX16r), END(nTimeX16r));
+    return Hash(BEGIN(nTimeX16r), END(nTimeX16r));
+}
+
+uint256 CBlockHeader::GetPoWHash() const
+{
+    uint256 hashTime = GetX16RSelector(nTime);
     return HashX16R(BEGIN(nVersion), END(nNonce), hashTime);
 }
 
+void GetPoWHashes(const std::vector<const CBlockHeader*>& vHeaders, std::vector<uint256>& vHashes)
+{
+    vHashes.clear();
+    if (vHeaders.empty())
+        return;
+
+    std::vector<const unsigned char*> vInputs;
+    std::vector<uint256> vSelectors;
+    vInputs.reserve(vHeaders.size());
+    vSelectors.reserve(vHeaders.size());
+    for (const CBlockHeader* pheader : vHeaders) {
+        vInputs.push_back((const unsigned char*)BEGIN(pheader->nVersion));
+        vSelectors.push_back(GetX16RSelector(pheader->nTime));
+    }
+
+    // The hashed fields are laid out contiguously, as GetPoWHash relies on too
+    size_t nLen = END(vHeaders[0]->nNonce) - BEGIN(vHeaders[0]->nVersion);
+    vHashes.resize(vHeaders.size());
+    HashX16RMulti(vInputs.data(), nLen, vSelectors.data(), vHashes.data(), vHeaders.size());
+}
+
 uint256 CBlock::GetVeilDataHash() const
 {
     CVeilBlockData veilBlockData(hashMerkleRoot, hashWitnessMerkleRoot, mapAccumulatorHashes, hashPoFN);
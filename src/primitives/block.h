@@ -123,6 +123,12 @@ public:
     virtual ~CBlockHeader(){};
 };
 
+/** The hash whose nibbles select the X16R algorithm order for a header with this nTime. */
+uint256 GetX16RSelector(uint32_t nTime);
+
+/** Compute the proof-of-work hashes of several headers at once, see HashX16RMulti. */
+void GetPoWHashes(const std::vector<const CBlockHeader*>& vHeaders, std::vector<uint256>& vHashes);
+
 class CBlock : public CBlockHeader
 {
 public:
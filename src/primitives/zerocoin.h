@@ -7,6 +7,8 @@
 
 #include <amount.h>
 #include <limits.h>
+#include <map>
+#include <vector>
 #include "libzerocoin/bignum.h"
 #include "libzerocoin/Denominations.h"
 #include "key.h"
@@ -230,4 +232,101 @@ public:
     };
 };
 
+//The pubcoins minted in a single block, grouped by denomination. Kept in the zerocoinDB keyed by height so that
+//accumulator checkpoints and witnesses can be calculated without deserializing full blocks.
+class CBlockPubcoins
+{
+public:
+    uint256 hashBlock;
+    std::map<libzerocoin::CoinDenomination, std::vector<CBigNum> > mapPubcoins;
+
+    CBlockPubcoins()
+    {
+        SetNull();
+    }
+
+    explicit CBlockPubcoins(const uint256& hashBlock)
+    {
+        SetNull();
+        this->hashBlock = hashBlock;
+    }
+
+    void SetNull()
+    {
+        hashBlock = uint256();
+        mapPubcoins.clear();
+    }
+
+    void Add(libzerocoin::CoinDenomination denom, const CBigNum& bnValue) { mapPubcoins[denom].emplace_back(bnValue); }
+    bool IsEmpty() const { return mapPubcoins.empty(); }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hashBlock);
+        READWRITE(mapPubcoins);
+    };
+};
+
+//Cached accumulator witness for one of our mints. bnWitness holds every mint of the coin's denomination from the blocks
+//between the mint's checkpoint and nHeightNext (exclusive), other than the coin itself, so that it can be advanced by
+//only the mints added since instead of being rebuilt on every spend and stake attempt.
+class CCoinWitnessData
+{
+public:
+    CBigNum bnPubcoin;
+    libzerocoin::CoinDenomination denom;
+    int nHeightMint;
+    int nHeightNext;
+    uint256 hashBlockLast; //hash of the block at nHeightNext - 1, used to detect reorgs
+    CBigNum bnWitness;
+    int nMintsAdded;
+
+    CCoinWitnessData()
+    {
+        SetNull();
+    }
+
+    CCoinWitnessData(const CBigNum& bnPubcoin, libzerocoin::CoinDenomination denom)
+    {
+        SetNull();
+        this->bnPubcoin = bnPubcoin;
+        this->denom = denom;
+    }
+
+    //Forget the witness, keeping the coin it belongs to
+    void Reset()
+    {
+        nHeightMint = 0;
+        nHeightNext = 0;
+        hashBlockLast = uint256();
+        bnWitness = 0;
+        nMintsAdded = 0;
+    }
+
+    void SetNull()
+    {
+        bnPubcoin = 0;
+        denom = libzerocoin::ZQ_ERROR;
+        Reset();
+    }
+
+    bool IsNull() const { return nHeightNext == 0; }
+    uint256 GetPubcoinHash() const { return GetPubCoinHash(bnPubcoin); }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(bnPubcoin);
+        READWRITE(denom);
+        READWRITE(nHeightMint);
+        READWRITE(nHeightNext);
+        READWRITE(hashBlockLast);
+        READWRITE(bnWitness);
+        READWRITE(nMintsAdded);
+    };
+};
+
 #endif //PIVX_ZEROCOIN_H
@@ -30,6 +30,7 @@
 #include <hash.h>
 #include <validationinterface.h>
 #include <warnings.h>
+#include <veil/ringct/anon.h>
 
 #include <assert.h>
 #include <stdint.h>
@@ -1410,6 +1411,10 @@ UniValue mempoolInfoToJSON()
     ret.pushKV("maxmempool", (int64_t) maxmempool);
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(mempool.GetMinFee(maxmempool), ::minRelayTxFee).GetFeePerK()));
     ret.pushKV("minrelaytxfee", ValueFromAmount(::minRelayTxFee.GetFeePerK()));
+    uint64_t nMLSAGCacheHits, nMLSAGCacheMisses;
+    GetMLSAGCacheStats(nMLSAGCacheHits, nMLSAGCacheMisses);
+    ret.pushKV("mlsagcachehits", nMLSAGCacheHits);
+    ret.pushKV("mlsagcachemisses", nMLSAGCacheMisses);
 
     return ret;
 }
@@ -1428,6 +1433,8 @@ static UniValue getmempoolinfo(const JSONRPCRequest& request)
             "  \"maxmempool\": xxxxx,         (numeric) Maximum memory usage for the mempool\n"
             "  \"mempoolminfee\": xxxxx       (numeric) Minimum fee rate in " + CURRENCY_UNIT + "/kB for tx to be accepted. Is the maximum of minrelaytxfee and minimum mempool fee\n"
             "  \"minrelaytxfee\": xxxxx       (numeric) Current minimum relay fee for transactions\n"
+            "  \"mlsagcachehits\": xxxxx      (numeric) Anon transactions whose ring signatures were found in the MLSAG cache\n"
+            "  \"mlsagcachemisses\": xxxxx    (numeric) Anon transactions whose ring signatures had to be verified\n"
             "}\n"
             "\nExamples:\n"
             + HelpExampleCli("getmempoolinfo", "")
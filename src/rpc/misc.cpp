@@ -7,7 +7,9 @@
 #include <clientversion.h>
 #include <core_io.h>
 #include <crypto/ripemd160.h>
+#include <hash.h>
 #include <key_io.h>
+#include <memusage.h>
 #include <validation.h>
 #include <httpserver.h>
 #include <net.h>
@@ -26,6 +28,7 @@
 #endif
 #include <warnings.h>
 
+#include <set>
 #include <stdint.h>
 #ifdef HAVE_MALLOC_INFO
 #include <malloc.h>
@@ -290,6 +293,33 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCBlockIndexMemoryInfo()
+{
+    LOCK(cs_main);
+    const uint64_t nEntries = mapBlockIndex.size();
+    const uint64_t nZerocoinBytes = sizeof(CBlockIndex::mapZerocoinSupply) + sizeof(CBlockIndex::mapMintCounts) +
+                                    sizeof(CBlockIndex::pAccumulatorHashes);
+    const uint64_t nEntriesUsage = nEntries * memusage::MallocUsage(sizeof(CBlockIndex));
+    const uint64_t nMapUsage = memusage::DynamicUsage(mapBlockIndex);
+
+    // Accumulator checkpoints are shared by the entries that have the same ones, count each copy once
+    std::set<const CDenominationArray<uint256>*> setCheckpoints;
+    for (const auto& it : mapBlockIndex)
+        setCheckpoints.insert(it.second->pAccumulatorHashes.get());
+    const uint64_t nCheckpointUsage = setCheckpoints.size() * memusage::DynamicUsage(CBlockIndex::NullAccumulatorHashes());
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", nEntries);
+    obj.pushKV("entry_bytes", uint64_t(sizeof(CBlockIndex)));
+    obj.pushKV("zerocoin_bytes", nEntries * nZerocoinBytes);
+    obj.pushKV("index_bytes", nEntriesUsage);
+    obj.pushKV("map_bytes", nMapUsage);
+    obj.pushKV("checkpoints", uint64_t(setCheckpoints.size()));
+    obj.pushKV("checkpoint_bytes", nCheckpointUsage);
+    obj.pushKV("total", nEntriesUsage + nMapUsage + nCheckpointUsage);
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -331,6 +361,16 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"blockindex\": {           (json object) Estimated memory used by the block index\n"
+            "    \"entries\": xxxxx,       (numeric) Number of block index entries\n"
+            "    \"entry_bytes\": xxxxx,   (numeric) Size of one entry\n"
+            "    \"zerocoin_bytes\": xxxxx, (numeric) Bytes used by the zerocoin fields of all the entries\n"
+            "    \"index_bytes\": xxxxx,   (numeric) Bytes used by all the entries, including allocator overhead\n"
+            "    \"map_bytes\": xxxxx,     (numeric) Bytes used by the hash map that looks up entries by block hash\n"
+            "    \"checkpoints\": xxxxx,   (numeric) Number of distinct sets of accumulator checkpoints shared by the entries\n"
+            "    \"checkpoint_bytes\": xxxxx, (numeric) Bytes used by the accumulator checkpoints\n"
+            "    \"total\": xxxxx,         (numeric) index_bytes + map_bytes + checkpoint_bytes\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -344,6 +384,7 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("blockindex", RPCBlockIndexMemoryInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -434,6 +475,11 @@ UniValue logging(const JSONRPCRequest& request)
         }
     }
 
+    // The X16R step timers are only active while the x16r category is logged
+    if (changed_log_categories & BCLog::X16R) {
+        SetX16RProfiling(g_logger->WillLogCategory(BCLog::X16R));
+    }
+
     UniValue result(UniValue::VOBJ);
     std::vector<CLogCategoryActive> vLogCatActive = ListActiveLogCategories();
     for (const auto& logCatActive : vLogCatActive) {
@@ -443,6 +489,68 @@ UniValue logging(const JSONRPCRequest& request)
     return result;
 }
 
+static UniValue getx16rstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() > 1)
+        throw std::runtime_error(
+            "getx16rstats ( reset )\n"
+            "Returns the cumulative time spent in each of the sixteen X16R algorithms.\n"
+            "Timing is only collected while the \"x16r\" logging category is enabled (-debug=x16r or the logging RPC).\n"
+            "\nArguments:\n"
+            "1. reset              (boolean, optional, default=false) Clear the totals after reporting them\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"enabled\": true|false,  (boolean) If X16R timing is currently being collected\n"
+            "  \"time_ms\": xxxxx,       (numeric) Total time spent hashing, in milliseconds\n"
+            "  \"algorithms\": [         (json array) One entry per algorithm, in X16R selection order\n"
+            "    {\n"
+            "      \"algo\": n,          (numeric) The algorithm index selected by a hash nibble\n"
+            "      \"name\": \"name\",     (string) The algorithm name\n"
+            "      \"hashes\": n,        (numeric) Number of inputs hashed\n"
+            "      \"bytes\": n,         (numeric) Number of bytes hashed\n"
+            "      \"time_ms\": x.xxx,   (numeric) Time spent in this algorithm, in milliseconds\n"
+            "      \"avg_us\": x.xxx,    (numeric) Average time per input, in microseconds\n"
+            "      \"share\": x.xx,      (numeric) Percentage of the total hashing time\n"
+            "    }\n"
+            "    ,...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getx16rstats", "")
+            + HelpExampleCli("getx16rstats", "true")
+            + HelpExampleRpc("getx16rstats", "")
+        );
+
+    std::vector<X16RAlgoStats> vStats;
+    GetX16RStats(vStats);
+    if (!request.params[0].isNull() && request.params[0].get_bool())
+        ResetX16RStats();
+
+    uint64_t nTotalNanos = 0;
+    for (const X16RAlgoStats& stats : vStats)
+        nTotalNanos += stats.nTimeNanos;
+
+    UniValue algos(UniValue::VARR);
+    for (size_t i = 0; i < vStats.size(); i++) {
+        const X16RAlgoStats& stats = vStats[i];
+        UniValue algo(UniValue::VOBJ);
+        algo.pushKV("algo", (int)i);
+        algo.pushKV("name", GetX16RAlgoName(i));
+        algo.pushKV("hashes", stats.nHashes);
+        algo.pushKV("bytes", stats.nBytes);
+        algo.pushKV("time_ms", stats.nTimeNanos * 1e-6);
+        algo.pushKV("avg_us", stats.nHashes ? stats.nTimeNanos * 1e-3 / stats.nHashes : 0.0);
+        algo.pushKV("share", nTotalNanos ? stats.nTimeNanos * 100.0 / nTotalNanos : 0.0);
+        algos.push_back(algo);
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("enabled", IsX16RProfiling());
+    obj.pushKV("time_ms", nTotalNanos * 1e-6);
+    obj.pushKV("algorithms", algos);
+    return obj;
+}
+
 static UniValue echo(const JSONRPCRequest& request)
 {
     if (request.fHelp)
@@ -473,6 +581,7 @@ static const CRPCCommand commands[] =
   //  --------------------- ------------------------  -----------------------  ----------
     { "control",            "getmemoryinfo",          &getmemoryinfo,          {"mode"} },
     { "control",            "logging",                &logging,                {"include", "exclude"}},
+    { "control",            "getx16rstats",           &getx16rstats,           {"reset"} },
     { "util",               "validateaddress",        &validateaddress,        {"address"} }, /* uses wallet if enabled */
     { "util",               "createmultisig",         &createmultisig,         {"nrequired","keys"} },
     { "util",               "verifymessage",          &verifymessage,          {"address","signature","message"} },
@@ -2,7 +2,10 @@
 
 #include <stdlib.h>
 
+#include <chain.h>
+#include <clientversion.h>
 #include <rpc/blockchain.h>
+#include <streams.h>
 #include <test/test_veil.h>
 
 /* Equality between doubles is imprecise. Comparison should be done
@@ -75,4 +78,40 @@ BOOST_AUTO_TEST_CASE(get_difficulty_for_null_tip)
     RejectDifficultyMismatch(difficulty, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(disk_block_index_pow_hash)
+{
+    CBlockIndex* block_index = CreateBlockIndexWithNbits(0x1e0ffff0);
+    uint256 hash_block = block_index->GetBlockHeader().GetHash();
+    block_index->phashBlock = &hash_block;
+    uint256 pow_hash = block_index->GetBlockPoWHash();
+
+    // Without the status bit the hash is neither stored nor read back
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << CDiskBlockIndex(block_index);
+    CDiskBlockIndex disk_index;
+    ss >> disk_index;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(!(disk_index.nStatus & BLOCK_HAVE_POWHASH));
+    BOOST_CHECK(disk_index.hashPoW.IsNull());
+
+    block_index->SetBlockPoWHash(pow_hash);
+    ss << CDiskBlockIndex(block_index);
+    ss >> disk_index;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(disk_index.nStatus & BLOCK_HAVE_POWHASH);
+    BOOST_CHECK(disk_index.hashPoW == pow_hash);
+    BOOST_CHECK(disk_index.GetBlockPoWHash() == pow_hash);
+
+    // An entry rewritten by an older version keeps the status bit but loses the hash, which must then be recomputed
+    ss << CDiskBlockIndex(block_index);
+    std::vector<char> entry(ss.begin(), ss.end() - pow_hash.size());
+    CDataStream ss_old(entry, SER_DISK, CLIENT_VERSION);
+    CDiskBlockIndex old_index;
+    ss_old >> old_index;
+    BOOST_CHECK(!(old_index.nStatus & BLOCK_HAVE_POWHASH));
+    BOOST_CHECK(old_index.hashPoW.IsNull());
+
+    delete block_index;
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <clientversion.h>
+#include <consensus/merkle.h>
+#include <hash.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <test/test_veil.h>
+#include <veil/proofoffullnode/proofoffullnode.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(proofoffullnode_tests, BasicTestingSetup)
+
+// One round as GenerateProofOfFullNodeVector computed it before it worked on the raw block: mutate a copy of the
+// selected transaction, move the transactions below the seed to the front one at a time and take BlockMerkleRoot.
+static uint256 OldProofOfFullNodeRound(CBlock block, const uint256& hashCommitToChain, uint32_t nCommitNumber)
+{
+    uint32_t nRandTx = nCommitNumber % block.vtx.size();
+    nRandTx = std::min(nRandTx, (uint32_t)block.vtx.size() - 1);
+    CMutableTransaction txMutate(*block.vtx[nRandTx]);
+
+    for (auto& txin : txMutate.vin)
+        txin.nSequence = nCommitNumber;
+    uint256 hashMutatedTx = txMutate.GetHash();
+
+    uint256 seed = Hash(hashMutatedTx.begin(), hashMutatedTx.end(), hashCommitToChain.begin(), hashCommitToChain.end());
+    CTransaction tx(txMutate);
+    block.vtx.emplace_back(MakeTransactionRef(tx));
+    auto vtxMutate = block.vtx;
+    vtxMutate.clear();
+    for (auto& t : block.vtx) {
+        if (t->GetHash() < seed)
+            vtxMutate.insert(vtxMutate.begin(), t);
+        else
+            vtxMutate.emplace_back(t);
+    }
+    block.vtx = vtxMutate;
+
+    uint256 hashMutatedRoot = BlockMerkleRoot(block);
+    return Hash(hashMutatedRoot.begin(), hashMutatedRoot.end(), seed.begin(), seed.end());
+}
+
+static CBlock CreateBlock(size_t nTx)
+{
+    CBlock block;
+    block.nVersion = 1;
+    block.hashPrevBlock = InsecureRand256();
+    block.nTime = InsecureRand32();
+    for (size_t i = 0; i < nTx; i++) {
+        CMutableTransaction tx;
+        // A coinbase like first transaction, then a varying number of inputs
+        if (i == 0) {
+            tx.vin.emplace_back(COutPoint(), CScript() << 1000);
+        } else {
+            for (size_t j = 0; j < 1 + i % 3; j++)
+                tx.vin.emplace_back(COutPoint(InsecureRand256(), j), CScript() << std::vector<unsigned char>(72, i));
+        }
+        tx.vpout.emplace_back(MAKE_OUTPUT<CTxOutStandard>(i * COIN, CScript() << std::vector<unsigned char>(25, i)));
+        block.vtx.emplace_back(MakeTransactionRef(std::move(tx)));
+    }
+    block.hashMerkleRoot = BlockMerkleRoot(block);
+    return block;
+}
+
+BOOST_AUTO_TEST_CASE(pofn_round_matches_old_algorithm)
+{
+    for (size_t nTx : {1, 2, 3, 7, 64, 301}) {
+        CBlock block = CreateBlock(nTx);
+        CDataStream ssBlock(SER_DISK, CLIENT_VERSION);
+        ssBlock << block;
+        std::vector<uint8_t> vchBlock(ssBlock.begin(), ssBlock.end());
+
+        for (int i = 0; i < 8; i++) {
+            uint256 hashCommitToChain = InsecureRand256();
+            uint32_t nCommitNumber = i == 0 ? 0 : InsecureRand32();
+
+            CDataStream ss(vchBlock, SER_DISK, CLIENT_VERSION);
+            uint256 hashMutatedRoot;
+            BOOST_CHECK(veil::GetProofOfFullNodeRound(ss, block.GetHash(), hashCommitToChain, nCommitNumber, hashMutatedRoot));
+            BOOST_CHECK_EQUAL(hashMutatedRoot, OldProofOfFullNodeRound(block, hashCommitToChain, nCommitNumber));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pofn_round_rejects_other_block)
+{
+    CBlock block = CreateBlock(5);
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << block;
+    uint256 hashMutatedRoot;
+    BOOST_CHECK(!veil::GetProofOfFullNodeRound(ss, InsecureRand256(), InsecureRand256(), 1, hashMutatedRoot));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
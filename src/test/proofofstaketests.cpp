@@ -14,6 +14,7 @@
 #include <validation.h>
 #include <validationinterface.h>
 #include <veil/budget.h>
+#include <veil/proofofstake/kernel.h>
 #include <script/standard.h>
 #include <key_io.h>
 #include <veil/zerocoin/accumulators.h>
@@ -151,4 +152,37 @@ BOOST_AUTO_TEST_CASE(proofofstake_block)
 
 }
 
+BOOST_AUTO_TEST_CASE(stake_kernel_midstate)
+{
+    CDataStream ssUniqueID(SER_GETHASH, 0);
+    ssUniqueID << GetRandHash();
+    uint64_t nStakeModifier = GetRand(std::numeric_limits<uint64_t>::max());
+    unsigned int nTimeBlockFrom = 1546300800;
+    CAmount nValueIn = 10 * COIN;
+    arith_uint256 bnTargetPerCoinDay;
+    bnTargetPerCoinDay.SetCompact(0x1e0ffff0);
+
+    // The midstate kernel must hash exactly what the full serialization does
+    CStakeKernel kernel(ssUniqueID, nValueIn, nStakeModifier, bnTargetPerCoinDay, nTimeBlockFrom);
+    for (unsigned int nTimeTx = nTimeBlockFrom; nTimeTx < nTimeBlockFrom + 100; nTimeTx++) {
+        CDataStream ss(SER_GETHASH, 0);
+        ss << nStakeModifier << nTimeBlockFrom << ssUniqueID << nTimeTx;
+        uint256 hashExpected = Hash(ss.begin(), ss.end());
+
+        uint256 hashProofOfStake;
+        bool fHit = kernel.CheckTime(nTimeTx, hashProofOfStake);
+        BOOST_CHECK(hashProofOfStake == hashExpected);
+        BOOST_CHECK_EQUAL(fHit, stakeTargetHit(UintToArith256(hashExpected), nValueIn, bnTargetPerCoinDay));
+    }
+
+    // A target that every hash meets is hit at the latest timestamp first, by the lowest indexed kernel
+    std::vector<CStakeKernel> vKernels(200, CStakeKernel(ssUniqueID, nValueIn, nStakeModifier, ~arith_uint256(), nTimeBlockFrom));
+    unsigned int nTimeTxOut = 0;
+    uint256 hashProofOfStake;
+    BOOST_CHECK_EQUAL(FindStakeKernel(vKernels, 0, nTimeBlockFrom, nTimeTxOut, hashProofOfStake), 0U);
+    BOOST_CHECK_EQUAL(nTimeTxOut, nTimeBlockFrom + STAKE_HASH_DRIFT);
+    BOOST_CHECK_EQUAL(FindStakeKernel(vKernels, 150, nTimeBlockFrom, nTimeTxOut, hashProofOfStake), 150U);
+    BOOST_CHECK_EQUAL(FindStakeKernel(vKernels, 200, nTimeBlockFrom, nTimeTxOut, hashProofOfStake), 200U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -6,8 +6,10 @@
 
 #include <chainparams.h>
 #include <consensus/consensus.h>
+#include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <crypto/sha256.h>
+#include <crypto/x16r/x16r_4way.h>
 #include <validation.h>
 #include <miner.h>
 #include <net_processing.h>
@@ -17,6 +19,7 @@
 #include <rpc/server.h>
 #include <rpc/register.h>
 #include <script/sigcache.h>
+#include <veil/ringct/anon.h>
 
 void CConnmanTest::AddNode(CNode& node)
 {
@@ -49,12 +52,16 @@ BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
     : m_path_root(fs::temp_directory_path() / "test_veil" / strprintf("%lu_%i", (unsigned long)GetTime(), (int)(InsecureRandRange(1 << 30))))
 {
     SHA256AutoDetect();
+    X16RAutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
     SetupNetworking();
     InitSignatureCache();
     InitScriptExecutionCache();
+    InitRangeProofCache();
+    InitMLSAGCache();
+    InitZerocoinSpendCache();
     fCheckBlockIndex = true;
     SelectParams(chainName);
     noui_connect();
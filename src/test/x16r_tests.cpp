@@ -0,0 +1,117 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/x16r/x16r_4way.h>
+#include <hash.h>
+#include <primitives/block.h>
+#include <test/test_veil.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(x16r_tests, BasicTestingSetup)
+
+static std::vector<std::vector<unsigned char>> RandomInputs(size_t nCount, size_t nLen)
+{
+    std::vector<std::vector<unsigned char>> vInputs(nCount, std::vector<unsigned char>(nLen));
+    for (auto& vInput : vInputs) {
+        for (unsigned char& c : vInput)
+            c = InsecureRandBits(8);
+    }
+    return vInputs;
+}
+
+// Hash the inputs with HashX16RMulti and check every lane against the scalar HashX16R
+static void CheckMulti(const std::vector<std::vector<unsigned char>>& vInputs, const std::vector<uint256>& vSelectors)
+{
+    std::vector<const unsigned char*> vIn;
+    for (const auto& vInput : vInputs)
+        vIn.push_back(vInput.data());
+    std::vector<uint256> vOut(vInputs.size());
+    HashX16RMulti(vIn.data(), vInputs[0].size(), vSelectors.data(), vOut.data(), vInputs.size());
+
+    for (size_t k = 0; k < vInputs.size(); k++)
+        BOOST_CHECK_EQUAL(vOut[k], HashX16R(vInputs[k].begin(), vInputs[k].end(), vSelectors[k]));
+}
+
+BOOST_AUTO_TEST_CASE(x16r_4way_transforms)
+{
+    // Only the algorithms with a multi-buffer implementation on this machine are checked
+    for (size_t nLen : {80, 64}) {
+        for (int nAlgo = 0; nAlgo < 16; nAlgo++) {
+            X16RTransform4Way transform = X16RGetTransform4Way(nAlgo);
+            if (!transform)
+                continue;
+
+            std::vector<std::vector<unsigned char>> vInputs = RandomInputs(X16R_4WAY_LANES, nLen);
+            std::vector<uint512> vOut(X16R_4WAY_LANES);
+            const unsigned char* in[X16R_4WAY_LANES];
+            unsigned char* out[X16R_4WAY_LANES];
+            for (size_t j = 0; j < X16R_4WAY_LANES; j++) {
+                in[j] = vInputs[j].data();
+                out[j] = vOut[j].begin();
+            }
+            transform(out, in, nLen);
+
+            for (size_t j = 0; j < X16R_4WAY_LANES; j++) {
+                uint512 expected;
+                HashX16RStep(nAlgo, vInputs[j].data(), nLen, expected.begin());
+                BOOST_CHECK_MESSAGE(vOut[j] == expected, GetX16RAlgoName(nAlgo) << " lane " << j << " len " << nLen);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(x16r_multi_matches_scalar)
+{
+    for (size_t nLen : {80, 64}) {
+        for (size_t nCount = 1; nCount <= 9; nCount++) {
+            std::vector<std::vector<unsigned char>> vInputs = RandomInputs(nCount, nLen);
+
+            // Every lane on its own algorithm order
+            std::vector<uint256> vSelectors;
+            for (size_t k = 0; k < nCount; k++)
+                vSelectors.push_back(InsecureRand256());
+            CheckMulti(vInputs, vSelectors);
+
+            // Every lane on the same order, so all of them share each step and partial groups get padded
+            CheckMulti(vInputs, std::vector<uint256>(nCount, InsecureRand256()));
+
+            // Two orders mixed
+            uint256 hashOther = InsecureRand256();
+            for (size_t k = 0; k < nCount; k += 2)
+                vSelectors[k] = hashOther;
+            CheckMulti(vInputs, vSelectors);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(x16r_pow_hashes)
+{
+    for (size_t nCount = 1; nCount <= 6; nCount++) {
+        std::vector<CBlockHeader> vHeaders(nCount);
+        for (size_t k = 0; k < nCount; k++) {
+            vHeaders[k].nVersion = InsecureRand32();
+            vHeaders[k].hashPrevBlock = InsecureRand256();
+            vHeaders[k].hashVeilData = InsecureRand256();
+            // Headers in the same 128 second window share an algorithm order
+            vHeaders[k].nTime = k % 2 ? 1550000000 : InsecureRand32();
+            vHeaders[k].nBits = InsecureRand32();
+            vHeaders[k].nNonce = InsecureRand32();
+        }
+
+        std::vector<const CBlockHeader*> vpHeaders;
+        for (const CBlockHeader& header : vHeaders)
+            vpHeaders.push_back(&header);
+        std::vector<uint256> vHashes;
+        GetPoWHashes(vpHeaders, vHashes);
+
+        BOOST_CHECK_EQUAL(vHashes.size(), nCount);
+        for (size_t k = 0; k < nCount; k++)
+            BOOST_CHECK_EQUAL(vHashes[k], vHeaders[k].GetPoWHash());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,276 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <test/test_veil.h>
+#include <veil/zerocoin/accumulatormap.h>
+#include <veil/zerocoin/accumulators.h>
+
+#include <map>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_checkpoint_tests, BasicTestingSetup)
+
+static std::map<libzerocoin::CoinDenomination, uint256> RandomCheckpoints()
+{
+    std::map<libzerocoin::CoinDenomination, uint256> mapCheckpoints;
+    for (auto denom : libzerocoin::zerocoinDenomList)
+        mapCheckpoints[denom] = InsecureRandBool() ? uint256() : InsecureRand256();
+    return mapCheckpoints;
+}
+
+BOOST_AUTO_TEST_CASE(denomination_array_serialization)
+{
+    for (int i = 0; i < 16; i++) {
+        std::map<libzerocoin::CoinDenomination, uint256> mapCheckpoints = RandomCheckpoints();
+        CDenominationArray<uint256> arrayCheckpoints;
+        arrayCheckpoints = mapCheckpoints;
+        BOOST_CHECK(CDenominationArray<uint256>::IsCanonical(mapCheckpoints));
+
+        // The block index kept a std::map before, so both have to give the same bytes
+        CDataStream ssMap(SER_DISK, CLIENT_VERSION);
+        ssMap << mapCheckpoints;
+        CDataStream ssArray(SER_DISK, CLIENT_VERSION);
+        ssArray << arrayCheckpoints;
+        BOOST_CHECK(ssMap.str() == ssArray.str());
+
+        // And each one reads what the other wrote
+        CDenominationArray<uint256> arrayRead;
+        ssMap >> arrayRead;
+        BOOST_CHECK(arrayRead == arrayCheckpoints);
+        std::map<libzerocoin::CoinDenomination, uint256> mapRead;
+        ssArray >> mapRead;
+        BOOST_CHECK(mapRead == mapCheckpoints);
+        BOOST_CHECK(arrayRead.ToMap() == mapCheckpoints);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(denomination_array_canonical)
+{
+    std::map<libzerocoin::CoinDenomination, uint256> mapCheckpoints = RandomCheckpoints();
+    BOOST_CHECK(CDenominationArray<uint256>::IsCanonical(mapCheckpoints));
+
+    std::map<libzerocoin::CoinDenomination, uint256> mapExtra = mapCheckpoints;
+    mapExtra[libzerocoin::ZQ_ERROR] = InsecureRand256();
+    BOOST_CHECK(!CDenominationArray<uint256>::IsCanonical(mapExtra));
+
+    std::map<libzerocoin::CoinDenomination, uint256> mapMissing = mapCheckpoints;
+    mapMissing.erase(libzerocoin::zerocoinDenomList[2]);
+    BOOST_CHECK(!CDenominationArray<uint256>::IsCanonical(mapMissing));
+
+    std::map<libzerocoin::CoinDenomination, uint256> mapReplaced = mapMissing;
+    mapReplaced[libzerocoin::ZQ_ERROR] = uint256();
+    BOOST_CHECK(!CDenominationArray<uint256>::IsCanonical(mapReplaced));
+}
+
+BOOST_AUTO_TEST_CASE(checkpoint_must_hold_every_denomination)
+{
+    // Between checkpoint heights a block has to repeat the checkpoints of its parent exactly
+    CBlockIndex indexPrev;
+    indexPrev.nHeight = 4;
+    std::map<libzerocoin::CoinDenomination, uint256> mapCheckpoints = RandomCheckpoints();
+    indexPrev.SetAccumulatorHashes(mapCheckpoints);
+    CBlockIndex index;
+    index.nHeight = 5;
+    index.pprev = &indexPrev;
+
+    AccumulatorMap mapAccumulators(Params().Zerocoin_Params());
+    CBlock block;
+    block.mapAccumulatorHashes = mapCheckpoints;
+    BOOST_CHECK(ValidateAccumulatorCheckpoint(block, &index, mapAccumulators));
+
+    // Keys that the block index cannot keep are rejected instead of being dropped
+    block.mapAccumulatorHashes[libzerocoin::ZQ_ERROR] = InsecureRand256();
+    BOOST_CHECK(!ValidateAccumulatorCheckpoint(block, &index, mapAccumulators));
+
+    block.mapAccumulatorHashes = mapCheckpoints;
+    block.mapAccumulatorHashes.erase(libzerocoin::zerocoinDenomList[0]);
+    BOOST_CHECK(!ValidateAccumulatorCheckpoint(block, &index, mapAccumulators));
+
+    block.mapAccumulatorHashes = mapCheckpoints;
+    block.mapAccumulatorHashes[libzerocoin::zerocoinDenomList[3]] = InsecureRand256();
+    BOOST_CHECK(!ValidateAccumulatorCheckpoint(block, &index, mapAccumulators));
+}
+
+// Checkpoints for a chain of nCount entries that change at some of the heights divisible by 10, drawn from a small
+// pool so that the same checksum shows up again at later heights
+static std::vector<CDenominationArray<uint256>> RandomChainCheckpoints(size_t nCount, const CDenominationArray<uint256>& start,
+                                                                      const std::vector<uint256>& vPool)
+{
+    std::vector<CDenominationArray<uint256>> vCheckpoints;
+    CDenominationArray<uint256> checkpoints = start;
+    for (size_t i = 0; i < nCount; i++) {
+        if (InsecureRandBool()) {
+            for (auto denom : libzerocoin::zerocoinDenomList) {
+                if (InsecureRandBool())
+                    checkpoints[denom] = vPool[InsecureRandRange(vPool.size())];
+            }
+        }
+        vCheckpoints.emplace_back(checkpoints);
+    }
+    return vCheckpoints;
+}
+
+BOOST_AUTO_TEST_CASE(inherited_checkpoints_round_trip)
+{
+    std::vector<uint256> vPool = {uint256(), InsecureRand256(), InsecureRand256(), InsecureRand256()};
+    std::vector<CDenominationArray<uint256>> vChanges = RandomChainCheckpoints(8, CDenominationArray<uint256>(), vPool);
+
+    // Entries 0 to 59 are connected, the last ones only have their headers
+    const int nCount = 75;
+    const int nConnected = 60;
+    std::vector<CBlockIndex> vIndex(nCount);
+    std::vector<uint256> vHashes(nCount);
+    for (int i = 0; i < nCount; i++) {
+        vHashes[i] = InsecureRand256();
+        vIndex[i].phashBlock = &vHashes[i];
+        vIndex[i].nHeight = i;
+        vIndex[i].pprev = i ? &vIndex[i - 1] : nullptr;
+        vIndex[i].nStatus = i < nConnected ? BLOCK_VALID_SCRIPTS : BLOCK_VALID_TREE;
+        vIndex[i].SetAccumulatorHashes(vChanges[i / 10]);
+    }
+
+    std::vector<CDiskBlockIndex> vLoaded(nCount);
+    for (int i = 0; i < nCount; i++) {
+        CDiskBlockIndex diskindex(&vIndex[i]);
+        bool fSame = i > 0 && vIndex[i].GetAccumulatorHashes() == vIndex[i - 1].GetAccumulatorHashes();
+        bool fInherit = fSame && i < nConnected;
+        BOOST_CHECK_EQUAL(bool(diskindex.nStatus & BLOCK_INHERIT_CHECKPOINTS), fInherit);
+        BOOST_CHECK(!(vIndex[i].nStatus & BLOCK_INHERIT_CHECKPOINTS));
+
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss << diskindex;
+        if (fInherit) {
+            // The checkpoints are left out, and the status takes one more byte for the flag
+            CDataStream ssStored(SER_DISK, CLIENT_VERSION);
+            diskindex.nStatus &= ~BLOCK_INHERIT_CHECKPOINTS;
+            ssStored << diskindex;
+            CDataStream ssCheckpoints(SER_DISK, CLIENT_VERSION);
+            ssCheckpoints << vIndex[i].GetAccumulatorHashes();
+            BOOST_CHECK_EQUAL(ss.size() + ssCheckpoints.size(), ssStored.size() + 1);
+        }
+
+        // Read it back the way LoadBlockIndex does, in height order with pprev already loaded
+        ss >> vLoaded[i];
+        BOOST_CHECK(ss.empty());
+        vLoaded[i].pprev = i ? &vLoaded[i - 1] : nullptr;
+        vLoaded[i].LoadAccumulatorHashes();
+
+        BOOST_CHECK(!(vLoaded[i].nStatus & BLOCK_INHERIT_CHECKPOINTS));
+        BOOST_CHECK(vLoaded[i].nStatus == vIndex[i].nStatus);
+        BOOST_CHECK(vLoaded[i].GetAccumulatorHashes() == vIndex[i].GetAccumulatorHashes());
+        // Connected or not, equal checkpoints end up as one shared copy
+        if (fSame)
+            BOOST_CHECK(vLoaded[i].pAccumulatorHashes == vLoaded[i - 1].pAccumulatorHashes);
+    }
+}
+
+// GetChecksumHeight as it was before the heights were indexed: walk the checkpoint heights of the chain
+static int OldChecksumHeight(const CChain& chain, uint256 hashChecksum, libzerocoin::CoinDenomination denomination)
+{
+    CBlockIndex* pindex = chain[0];
+    if (!pindex)
+        return 0;
+
+    while (pindex) {
+        if (pindex->GetAccumulatorHash(denomination) == hashChecksum)
+            return pindex->nHeight;
+
+        if (pindex->nHeight % 10 == 0) {
+            if (pindex->nHeight + 10 > chain.Height())
+                return 0;
+            pindex = chain[pindex->nHeight + 10];
+            continue;
+        }
+
+        pindex = chain.Next(pindex);
+    }
+
+    return 0;
+}
+
+static void CheckChecksumHeights(const CChain& chain, const std::vector<uint256>& vPool)
+{
+    for (auto denom : libzerocoin::zerocoinDenomList) {
+        for (const uint256& hashChecksum : vPool)
+            BOOST_CHECK_EQUAL(GetChecksumHeight(hashChecksum, denom), OldChecksumHeight(chain, hashChecksum, denom));
+    }
+}
+
+// Build nCount entries on top of pindexFork, with checkpoints that only change at heights divisible by 10
+static void ExtendBranch(std::vector<CBlockIndex>& vBranch, CBlockIndex* pindexFork, const std::vector<uint256>& vPool)
+{
+    std::vector<CDenominationArray<uint256>> vChanges =
+        RandomChainCheckpoints(vBranch.size() / 10 + 2, pindexFork->GetAccumulatorHashes(), vPool);
+    for (size_t i = 0; i < vBranch.size(); i++) {
+        CBlockIndex* pindexPrev = i ? &vBranch[i - 1] : pindexFork;
+        vBranch[i].nHeight = pindexPrev->nHeight + 1;
+        vBranch[i].pprev = pindexPrev;
+        if (vBranch[i].nHeight % 10 == 0)
+            vBranch[i].SetAccumulatorHashes(vChanges[i / 10 + 1]);
+        else
+            vBranch[i].SetAccumulatorHashes(pindexPrev->GetAccumulatorHashes());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(checksum_height_matches_chain_walk)
+{
+    std::vector<uint256> vPool = {uint256(), InsecureRand256(), InsecureRand256(), InsecureRand256(), InsecureRand256()};
+    std::vector<uint256> vQueries = vPool;
+    vQueries.emplace_back(InsecureRand256());
+
+    CBlockIndex genesis;
+    std::vector<CBlockIndex> vMain(64);
+    ExtendBranch(vMain, &genesis, vPool);
+    std::vector<CBlockIndex> vFork(50);
+    ExtendBranch(vFork, &vMain[24], vPool);
+
+    // ConnectTip and DisconnectTip keep the heights up to date around SetTip
+    CChain chain;
+    chain.SetTip(&genesis);
+    LoadChecksumHeights(chain);
+    CheckChecksumHeights(chain, vQueries);
+    for (CBlockIndex& index : vMain) {
+        chain.SetTip(&index);
+        AddChecksumHeights(&index);
+        CheckChecksumHeights(chain, vQueries);
+    }
+
+    // Reorganize to the fork at height 25 and back to a longer main chain
+    while (chain.Tip() != &vMain[24]) {
+        RemoveChecksumHeights(chain.Tip());
+        chain.SetTip(chain.Tip()->pprev);
+        CheckChecksumHeights(chain, vQueries);
+    }
+    for (CBlockIndex& index : vFork) {
+        chain.SetTip(&index);
+        AddChecksumHeights(&index);
+        CheckChecksumHeights(chain, vQueries);
+    }
+    while (chain.Tip() != &vMain[24]) {
+        RemoveChecksumHeights(chain.Tip());
+        chain.SetTip(chain.Tip()->pprev);
+        CheckChecksumHeights(chain, vQueries);
+    }
+    for (int i = 25; i < (int)vMain.size(); i++) {
+        chain.SetTip(&vMain[i]);
+        AddChecksumHeights(&vMain[i]);
+        CheckChecksumHeights(chain, vQueries);
+    }
+
+    // Rebuilding from the chain gives the same answers
+    LoadChecksumHeights(chain);
+    CheckChecksumHeights(chain, vQueries);
+
+    chain.SetTip(nullptr);
+    LoadChecksumHeights(chain);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
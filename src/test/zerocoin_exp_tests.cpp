@@ -0,0 +1,116 @@
+// Copyright (c) 2019 The Veil developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <libzerocoin/FixedBaseExp.h>
+#include <libzerocoin/MultiExp.h>
+#include <libzerocoin/Params.h>
+#include <test/test_veil.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace libzerocoin;
+
+BOOST_FIXTURE_TEST_SUITE(zerocoin_exp_tests, BasicTestingSetup)
+
+// Exponents around the edges of the table: zero, the order itself, beyond the order and negative
+static std::vector<CBigNum> TestExponents(const CBigNum& order)
+{
+    std::vector<CBigNum> vExps = {CBigNum(0), CBigNum(1), CBigNum(15), CBigNum(16), order - CBigNum(1), order,
+                                  order + CBigNum(1), order * CBigNum(2), CBigNum(-1), -order};
+    for (int i = 0; i < 8; i++) {
+        CBigNum x = CBigNum::randBignum(order);
+        vExps.emplace_back(x);
+        vExps.emplace_back(order + x);
+        vExps.emplace_back(x * order + x);
+        vExps.emplace_back(-x);
+    }
+    return vExps;
+}
+
+static void CheckGroup(const IntegerGroupParams& group, const std::string& strName)
+{
+    for (const CBigNum& x : TestExponents(group.groupOrder)) {
+        BOOST_CHECK_MESSAGE(group.ExpG(x) == group.g.pow_mod(x, group.modulus), strName << " g^" << x.ToString(16));
+        BOOST_CHECK_MESSAGE(group.ExpH(x) == group.h.pow_mod(x, group.modulus), strName << " h^" << x.ToString(16));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fixed_base_exp_matches_pow_mod)
+{
+    const ZerocoinParams* params = Params().Zerocoin_Params();
+    CheckGroup(params->coinCommitmentGroup, "coinCommitmentGroup");
+    CheckGroup(params->serialNumberSoKCommitmentGroup, "serialNumberSoKCommitmentGroup");
+    CheckGroup(params->accumulatorParams.accumulatorPoKCommitmentGroup, "accumulatorPoKCommitmentGroup");
+}
+
+BOOST_AUTO_TEST_CASE(fixed_base_exp_new_base)
+{
+    // A FixedBaseExp that is given another base, or is copied, must not reuse the powers of the old one
+    const IntegerGroupParams& group = Params().Zerocoin_Params()->coinCommitmentGroup;
+    FixedBaseExp fixed;
+    CBigNum x = CBigNum::randBignum(group.groupOrder);
+    BOOST_CHECK(fixed.Exp(group.g, x, group.modulus, group.groupOrder) == group.g.pow_mod(x, group.modulus));
+    BOOST_CHECK(fixed.Exp(group.h, x, group.modulus, group.groupOrder) == group.h.pow_mod(x, group.modulus));
+
+    FixedBaseExp copy(fixed);
+    BOOST_CHECK(copy.Exp(group.g, x, group.modulus, group.groupOrder) == group.g.pow_mod(x, group.modulus));
+}
+
+// The product of pow_mod over every term, which MultiExp must reproduce
+static CBigNum NaiveMultiExp(const CBN_vector& vBases, const CBN_vector& vExps, const CBigNum& modulus)
+{
+    CBigNum result(1);
+    for (size_t i = 0; i < vBases.size(); i++)
+        result = result.mul_mod(vBases[i].pow_mod(vExps[i], modulus), modulus);
+    return result;
+}
+
+static void CheckMultiExp(size_t nTerms, const CBigNum& bnExpRange, const IntegerGroupParams& group)
+{
+    CBN_vector vBases, vExps;
+    for (size_t i = 0; i < nTerms; i++) {
+        vBases.emplace_back(CBigNum::randBignum(group.modulus - CBigNum(2)) + CBigNum(1));
+        CBigNum x = CBigNum::randBignum(bnExpRange);
+        // Mix in zero, one, negative and oversized exponents
+        if (i % 5 == 1)
+            x = CBigNum(0);
+        else if (i % 7 == 2)
+            x = -x;
+        else if (i % 11 == 3)
+            x = CBigNum(1);
+        else if (i % 13 == 4)
+            x = group.groupOrder * CBigNum(3) + x;
+        vExps.emplace_back(x);
+    }
+    BOOST_CHECK_MESSAGE(MultiExp(vBases, vExps, group.modulus) == NaiveMultiExp(vBases, vExps, group.modulus),
+                        "terms " << nTerms << " exponent range " << bnExpRange.bitSize());
+}
+
+BOOST_AUTO_TEST_CASE(multi_exp_matches_pow_mod)
+{
+    const IntegerGroupParams& group = Params().Zerocoin_Params()->serialNumberSoKCommitmentGroup;
+
+    // Up to a few hundred bases take Straus' method
+    for (size_t nTerms : {1, 2, 3, 8, 33, 100, 400}) {
+        CheckMultiExp(nTerms, group.groupOrder, group);
+        CheckMultiExp(nTerms, CBigNum(1000), group);
+    }
+    // Thousands of bases with full size exponents take Pippenger's buckets
+    CheckMultiExp(2000, group.groupOrder, group);
+
+    // Only zero exponents, all negative ones, and the empty product
+    CBN_vector vBases = {group.g, group.h, group.gis[1]};
+    BOOST_CHECK(MultiExp(vBases, CBN_vector(3, CBigNum(0)), group.modulus) == CBigNum(1));
+    CBN_vector vExps = {CBigNum(-1), -group.groupOrder, CBigNum(-12345)};
+    BOOST_CHECK(MultiExp(vBases, vExps, group.modulus) == NaiveMultiExp(vBases, vExps, group.modulus));
+    BOOST_CHECK(MultiExp(CBN_vector(), CBN_vector(), group.modulus) == CBigNum(1));
+
+    BOOST_CHECK_THROW(MultiExp(vBases, CBN_vector(2, CBigNum(1)), group.modulus), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -472,6 +472,31 @@ BOOST_AUTO_TEST_CASE(setup_exceptions_test)
 
 }
 
+BOOST_AUTO_TEST_CASE(accumulator_batch_test)
+{
+    cout << "Running accumulator_batch_test...\n";
+    SelectParams(CBaseChainParams::MAIN);
+    ZerocoinParams* params = Params().Zerocoin_Params();
+
+    std::vector<CBigNum> vValues;
+    for (int i = 0; i < 25; i++)
+        vValues.emplace_back(CBigNum::randBignum(params->accumulatorParams.maxCoinValue));
+
+    //accumulating one at a time and as a batch must give the same accumulator value
+    Accumulator accSerial(params, CoinDenomination::ZQ_TEN);
+    for (const CBigNum& bnValue : vValues)
+        accSerial.increment(bnValue);
+
+    Accumulator accBatch(params, CoinDenomination::ZQ_TEN);
+    accBatch.incrementBatch(vValues);
+    BOOST_CHECK_MESSAGE(accSerial.getValue() == accBatch.getValue(), "Batched accumulator does not match serial accumulator");
+
+    //an empty batch leaves the accumulator untouched
+    CBigNum bnBefore = accBatch.getValue();
+    accBatch.incrementBatch(std::vector<CBigNum>());
+    BOOST_CHECK(accBatch.getValue() == bnBefore);
+}
+
 BOOST_AUTO_TEST_CASE(deterministic_tests)
 {
     SelectParams(CBaseChainParams::TESTNET);
@@ -35,6 +35,7 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_BLOCK_INDEX_VERSION = 'V';
 
 namespace {
 
@@ -175,6 +176,14 @@ bool CBlockTreeDB::ReadLastBlockFile(int &nFile) {
     return Read(DB_LAST_BLOCK, nFile);
 }
 
+bool CBlockTreeDB::ReadBlockIndexVersion(int &nVersion) {
+    return Read(DB_BLOCK_INDEX_VERSION, nVersion);
+}
+
+bool CBlockTreeDB::WriteBlockIndexVersion(int nVersion) {
+    return Write(DB_BLOCK_INDEX_VERSION, nVersion);
+}
+
 CCoinsViewCursor *CCoinsViewDB::Cursor() const
 {
     CCoinsViewDBCursor *i = new CCoinsViewDBCursor(const_cast<CDBWrapper&>(db).NewIterator(), GetBestBlock());
@@ -282,6 +291,7 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->nBits          = diskindex.nBits;
                 pindexNew->nNonce         = diskindex.nNonce;
                 pindexNew->nStatus        = diskindex.nStatus;
+                pindexNew->hashPoW        = diskindex.hashPoW;
                 pindexNew->nTx            = diskindex.nTx;
                 pindexNew->nNetworkRewardReserve = diskindex.nNetworkRewardReserve;
 
@@ -297,9 +307,9 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->nAnonOutputs             = diskindex.nAnonOutputs;
 
                 // zerocoin
-                pindexNew->mapAccumulatorHashes = diskindex.mapAccumulatorHashes;
+                pindexNew->pAccumulatorHashes = diskindex.pAccumulatorHashes;
                 pindexNew->mapZerocoinSupply = diskindex.mapZerocoinSupply;
-                pindexNew->vMintDenominationsInBlock = diskindex.vMintDenominationsInBlock;
+                pindexNew->mapMintCounts = diskindex.mapMintCounts;
 
 //                if (pindexNew->IsProofOfWork() && !CheckProofOfWork(pindexNew->GetBlockPoWHash(), pindexNew->nBits, consensusParams))
 //                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
@@ -316,20 +326,71 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
     return true;
 }
 
+void CBlockTreeDB::InitRCTOutputCache(size_t nBytes)
+{
+    LOCK(cs_rctcache);
+    size_t nEntries = 1;
+    while (nEntries * 2 * sizeof(std::pair<int64_t, CAnonOutput>) <= nBytes)
+        nEntries *= 2;
+    if (nEntries * sizeof(std::pair<int64_t, CAnonOutput>) > nBytes)
+        nEntries = 0;
+
+    std::vector<std::pair<int64_t, CAnonOutput> >().swap(vRCTOutputCache);
+    vRCTOutputCache.resize(nEntries, std::make_pair(-1, CAnonOutput()));
+    nRCTOutputCacheMask = nEntries ? nEntries - 1 : 0;
+}
+
+void CBlockTreeDB::CacheRCTOutput(int64_t i, const CAnonOutput &ao)
+{
+    LOCK(cs_rctcache);
+    if (vRCTOutputCache.empty())
+        return;
+
+    auto &entry = vRCTOutputCache[i & nRCTOutputCacheMask];
+    entry.first = i;
+    entry.second = ao;
+}
+
 bool CBlockTreeDB::ReadRCTOutput(int64_t i, CAnonOutput &ao)
 {
-    return Read(std::make_pair(DB_RCTOUTPUT, i), ao);
+    {
+        LOCK(cs_rctcache);
+        if (!vRCTOutputCache.empty()) {
+            const auto &entry = vRCTOutputCache[i & nRCTOutputCacheMask];
+            if (entry.first == i) {
+                ao = entry.second;
+                return true;
+            }
+        }
+    }
+
+    if (!Read(std::make_pair(DB_RCTOUTPUT, i), ao))
+        return false;
+
+    CacheRCTOutput(i, ao);
+    return true;
 };
 
 bool CBlockTreeDB::WriteRCTOutput(int64_t i, const CAnonOutput &ao)
 {
     CDBBatch batch(*this);
     batch.Write(std::make_pair(DB_RCTOUTPUT, i), ao);
-    return WriteBatch(batch);
+    if (!WriteBatch(batch))
+        return false;
+
+    CacheRCTOutput(i, ao);
+    return true;
 };
 
 bool CBlockTreeDB::EraseRCTOutput(int64_t i)
 {
+    nRCTOutputEraseCount++;
+    {
+        LOCK(cs_rctcache);
+        if (!vRCTOutputCache.empty() && vRCTOutputCache[i & nRCTOutputCacheMask].first == i)
+            vRCTOutputCache[i & nRCTOutputCacheMask].first = -1;
+    }
+
     CDBBatch batch(*this);
     batch.Erase(std::make_pair(DB_RCTOUTPUT, i));
     return WriteBatch(batch);
@@ -629,3 +690,18 @@ bool CZerocoinDB::EraseAccumulatorValue(const uint256& hashChecksum)
     LogPrint(BCLog::ZEROCOINDB, "%s : checksum:%d\n", __func__, hashChecksum.GetHex());
     return Erase(std::make_pair('2', hashChecksum));
 }
+
+bool CZerocoinDB::WriteBlockPubcoins(int nHeight, const CBlockPubcoins& pubcoins)
+{
+    return Write(std::make_pair('p', nHeight), pubcoins);
+}
+
+bool CZerocoinDB::ReadBlockPubcoins(int nHeight, CBlockPubcoins& pubcoins)
+{
+    return Read(std::make_pair('p', nHeight), pubcoins);
+}
+
+bool CZerocoinDB::EraseBlockPubcoins(int nHeight)
+{
+    return Erase(std::make_pair('p', nHeight));
+}
@@ -13,7 +13,10 @@
 #include <primitives/block.h>
 #include <libzerocoin/Coin.h>
 #include <libzerocoin/CoinSpend.h>
+#include <primitives/zerocoin.h>
+#include <sync.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -46,6 +49,10 @@ static const int64_t nMaxBlockDBCache = 2;
 static const int64_t nMaxTxIndexCache = 1024;
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
+//! Max memory allocated to the in-memory RingCT output cache (MiB)
+static const int64_t nMaxRCTOutputCache = 64;
+//! Format of the block index entries, 1 leaves out accumulator checkpoints that are the same as the previous block's
+static const int BLOCK_INDEX_VERSION = 1;
 
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB final : public CCoinsView
@@ -98,6 +105,9 @@ public:
     bool WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo);
     bool ReadBlockFileInfo(int nFile, CBlockFileInfo &info);
     bool ReadLastBlockFile(int &nFile);
+    //! A database without a version holds version 0 entries
+    bool ReadBlockIndexVersion(int &nVersion);
+    bool WriteBlockIndexVersion(int nVersion);
     bool WriteReindexing(bool fReindexing);
     void ReadReindexing(bool &fReindexing);
     bool WriteFlag(const std::string &name, bool fValue);
@@ -107,6 +117,12 @@ public:
     bool ReadRCTOutput(int64_t i, CAnonOutput &ao);
     bool WriteRCTOutput(int64_t i, const CAnonOutput &ao);
     bool EraseRCTOutput(int64_t i);
+    //! Size the anon output cache, nBytes is rounded down to a power of two number of entries
+    void InitRCTOutputCache(size_t nBytes);
+    //! Record an anon output that was written to the database outside of WriteRCTOutput
+    void CacheRCTOutput(int64_t i, const CAnonOutput &ao);
+    //! Number of anon outputs erased since startup, output indexes may have been reassigned if this changed
+    uint64_t GetRCTOutputEraseCount() const { return nRCTOutputEraseCount; }
 
     bool ReadRCTOutputLink(const CCmpPubKey &pk, int64_t &i);
     bool WriteRCTOutputLink(const CCmpPubKey &pk, int64_t i);
@@ -115,6 +131,14 @@ public:
     bool ReadRCTKeyImage(const CCmpPubKey &ki, uint256 &txhash);
     bool WriteRCTKeyImage(const CCmpPubKey &ki, const uint256 &txhash);
     bool EraseRCTKeyImage(const CCmpPubKey &ki);
+
+private:
+    /** Direct mapped cache of anon outputs. Output indexes are assigned densely, so slot i & mask
+     *  always holds the most recently used output of that slot and the newest outputs never collide. */
+    CCriticalSection cs_rctcache;
+    std::vector<std::pair<int64_t, CAnonOutput> > vRCTOutputCache;
+    uint64_t nRCTOutputCacheMask = 0;
+    std::atomic<uint64_t> nRCTOutputEraseCount{0};
 };
 
 /** Zerocoin database (zerocoin/) */
@@ -142,6 +166,10 @@ public:
     bool WriteAccumulatorValue(const uint256& nChecksum, const CBigNum& bnValue);
     bool ReadAccumulatorValue(const uint256& nChecksum, CBigNum& bnValue);
     bool EraseAccumulatorValue(const uint256& nChecksum);
+    /** Per-block pubcoin index, used to accumulate mints without reading blocks from disk */
+    bool WriteBlockPubcoins(int nHeight, const CBlockPubcoins& pubcoins);
+    bool ReadBlockPubcoins(int nHeight, CBlockPubcoins& pubcoins);
+    bool EraseBlockPubcoins(int nHeight);
 };
 
 #endif // BITCOIN_TXDB_H
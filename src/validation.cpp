@@ -181,7 +181,8 @@ public:
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to mapBlockIndex.
      */
-    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fProofOfStake, bool fProofOfFullNode) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    /** hashPoW, if not null, is the already computed PoW hash of the header. */
+    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fProofOfStake, bool fProofOfFullNode, uint256 hashPoW = uint256()) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool ContextualCheckZerocoinStake(CBlockIndex* pindex, CStakeInput* stake);
 
@@ -336,7 +337,7 @@ static void FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPr
 static void FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight);
 bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks,
         unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
-        std::vector<CScriptCheck> *pvChecks = nullptr, bool fAnonChecks = true);
+        std::vector<CScriptCheck> *pvChecks = nullptr, bool fAnonChecks = true, std::vector<CMLSAGCheck> *pvMLSAGChecks = nullptr);
 static FILE* OpenUndoFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 
 bool CheckFinalTx(const CTransaction &tx, int flags)
@@ -600,6 +601,36 @@ static bool CheckInputsFromMempoolAndCache(const CTransaction& tx, CValidationSt
     return CheckInputs(tx, state, view, true, flags, cacheSigStore, true, txdata);
 }
 
+static CCheckQueue<CRangeProofCheck> rangeproofcheckqueue(16);
+
+void ThreadRangeProofCheck() {
+    RenameThread("veil-rangech");
+    rangeproofcheckqueue.Thread();
+}
+
+/**
+ * Run range proof checks collected by CheckTransaction on the check queue. If any of them fails they are repeated in
+ * order, so that state gets the reject reason of the first bad output, the same as when they are verified inline.
+ */
+static bool VerifyRangeProofs(const std::vector<CRangeProofCheck>& vChecks, CValidationState& state)
+{
+    if (vChecks.empty())
+        return true;
+
+    // The queue takes the checks it is given, keep the originals for finding the failure
+    std::vector<CRangeProofCheck> vQueued(vChecks);
+    CCheckQueueControl<CRangeProofCheck> control(&rangeproofcheckqueue);
+    control.Add(vQueued);
+    if (control.Wait())
+        return true;
+
+    for (CRangeProofCheck check : vChecks) {
+        if (!check())
+            return state.DoS(100, false, REJECT_INVALID, check.GetRejectReason(), false, "range proof check failed");
+    }
+    return state.DoS(100, false, REJECT_INVALID, "bad-txout-rangeproof-verify", false, "range proof check failed");
+}
+
 static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool& pool, CValidationState& state, const CTransactionRef& ptx,
                               bool* pfMissingInputs, int64_t nAcceptTime, std::list<CTransactionRef>* plTxnReplaced,
                               bool bypass_limits, const CAmount& nAbsurdFee, std::vector<COutPoint>& coins_to_uncache, bool test_accept)
@@ -612,9 +643,13 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
         *pfMissingInputs = false;
     }
 
-    if (!CheckTransaction(tx, state))
+    std::vector<CRangeProofCheck> vRangeProofChecks;
+    if (!CheckTransaction(tx, state, true, nScriptCheckThreads ? &vRangeProofChecks : nullptr))
         return false; // state filled in by CheckTransaction
 
+    if (!VerifyRangeProofs(vRangeProofChecks, state))
+        return false; // state filled in by VerifyRangeProofs
+
     // Coinbase is only valid in a block, not as a loose transaction
     if (tx.IsCoinBase())
         return state.DoS(100, false, REJECT_INVALID, "coinbase");
@@ -761,6 +796,27 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
             }
         }
 
+        //Veil: verify the zerocoin spend proofs, this also fills the spend cache so the proofs are not verified
+        // again when the transaction is connected in a block
+        if (tx.IsZerocoinSpend()) {
+            for (const CTxIn& txin : tx.vin) {
+                if (!txin.scriptSig.IsZerocoinSpend())
+                    continue;
+                auto spend = TxInToZerocoinSpend(txin);
+                if (!spend)
+                    return state.DoS(100, false, REJECT_INVALID, "bad-zcspend");
+
+                // The spend can use an accumulator checkpoint that this node has not connected yet, for example while
+                // syncing or after a reorg, which is not the fault of the peer that relayed it
+                CBigNum bnAccumulatorValue;
+                if (!pzerocoinDB->ReadAccumulatorValue(spend->getAccumulatorChecksum(), bnAccumulatorValue))
+                    return state.Invalid(false, REJECT_INVALID, "zcspend-unknown-checkpoint");
+
+                if (!ContextualCheckZerocoinSpend(tx, *spend, uint256(), chainActive.Tip()))
+                    return state.DoS(100, false, REJECT_INVALID, "bad-zcspend");
+            }
+        }
+
         if (!AllAnonOutputsUnknown(tx, state)) // set state.fHasAnonOutput
             return error("%s: already spent anon outputs", __func__); // Already in the blockchain, containing block could have been received before loose tx
 
@@ -1526,6 +1582,8 @@ void InitScriptExecutionCache() {
  * script checks which are not necessary (eg due to script execution cache hits) are, obviously,
  * not pushed onto pvChecks/run.
  *
+ * If pvMLSAGChecks is not nullptr, the ring signature checks of anon inputs are pushed onto it in the same way.
+ *
  * Setting cacheSigStore/cacheFullScriptStore to false will remove elements from the corresponding cache
  * which are matched. This is useful for checking blocks where we will likely never need the cache
  * entry again.
@@ -1534,7 +1592,7 @@ void InitScriptExecutionCache() {
  */
 bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsViewCache &inputs, bool fScriptChecks,
         unsigned int flags, bool cacheSigStore, bool cacheFullScriptStore, PrecomputedTransactionData& txdata,
-        std::vector<CScriptCheck> *pvChecks, bool fAnonChecks)
+        std::vector<CScriptCheck> *pvChecks, bool fAnonChecks, std::vector<CMLSAGCheck> *pvMLSAGChecks)
 {
     if (!tx.IsCoinBase())
     {
@@ -1624,10 +1682,10 @@ bool CheckInputs(const CTransaction& tx, CValidationState &state, const CCoinsVi
                 }
             }
 
-            if (fHasAnonInput && fAnonChecks && !VerifyMLSAG(tx, state))
+            if (fHasAnonInput && fAnonChecks && !VerifyMLSAG(tx, state, pvMLSAGChecks, cacheSigStore))
                 return false;
 
-            if (cacheFullScriptStore && !pvChecks) {
+            if (cacheFullScriptStore && !pvChecks && !(fHasAnonInput && pvMLSAGChecks)) {
                 // We executed all of the provided scripts, and were told to
                 // cache the result. Do so now.
                 scriptExecutionCache.insert(hashCacheEntry);
@@ -1901,6 +1959,8 @@ DisconnectResult CChainState::DisconnectBlock(const CBlock& block, const CBlockI
         }
     }
 
+    pzerocoinDB->EraseBlockPubcoins(pindex->nHeight);
+
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
 
@@ -1963,6 +2023,13 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+static CCheckQueue<CMLSAGCheck> mlsagcheckqueue(32);
+
+void ThreadMLSAGCheck() {
+    RenameThread("veil-mlsagch");
+    mlsagcheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2066,7 +2133,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     // is enforced in ContextualCheckBlockHeader(); we wouldn't want to
     // re-enforce that rule here (at least until we make it impossible for
     // GetAdjustedTime() to go backward).
-    if (!CheckBlock(block, state, chainparams.GetConsensus(), !fJustCheck, !fJustCheck)) {
+    if (!CheckBlock(block, state, chainparams.GetConsensus(), !fJustCheck, !fJustCheck, pindex)) {
         if (state.CorruptionPossible()) {
             // We don't write down blocks to disk if they may have been
             // corrupted, so this should be impossible unless we're having hardware
@@ -2227,6 +2294,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     CBlockUndo blockundo;
 
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : nullptr);
+    CCheckQueueControl<CMLSAGCheck> mlsagcontrol(fScriptChecks && nScriptCheckThreads ? &mlsagcheckqueue : nullptr);
 
     std::vector<int> prevheights;
     CAmount nFees = 0;
@@ -2398,12 +2466,15 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
         txdata.emplace_back(tx);
         if (!tx.IsCoinBase()) {
             std::vector<CScriptCheck> vChecks;
+            std::vector<CMLSAGCheck> vMLSAGChecks;
             bool fCacheResults = fJustCheck; /* Don't cache results if we're actually connecting blocks (still consult the cache, though) */
-            if (!CheckInputs(tx, state, view, fScriptChecks, flags, fCacheResults, fCacheResults, txdata[i], nScriptCheckThreads ? &vChecks : nullptr))
+            if (!CheckInputs(tx, state, view, fScriptChecks, flags, fCacheResults, fCacheResults, txdata[i], nScriptCheckThreads ? &vChecks : nullptr,
+                    true, nScriptCheckThreads ? &vMLSAGChecks : nullptr))
                 return error("ConnectBlock(): CheckInputs on %s failed with %s",
                     tx.GetHash().ToString(), FormatStateMessage(state));
 
             control.Add(vChecks);
+            mlsagcontrol.Add(vMLSAGChecks);
 
             blockundo.vtxundo.push_back(CTxUndo());
             UpdateCoins(tx, view, blockundo.vtxundo.back(), pindex->nHeight);
@@ -2482,7 +2553,7 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     if (!AddZerocoinsToIndex(pindex, block, mapSpends, mapMints, fJustCheck))
         return state.DoS(100, error("%s: Failed to calculate new zerocoin supply for block=%s height=%d", __func__,
                                     block.GetHash().GetHex(), pindex->nHeight), REJECT_INVALID);
-    pindex->mapAccumulatorHashes = block.mapAccumulatorHashes;
+    pindex->SetAccumulatorHashes(block.mapAccumulatorHashes);
 
     // track money supply and mint amount info
     CAmount nMoneySupplyPrev = pindex->pprev ? pindex->pprev->nMoneySupply : 0;
@@ -2573,6 +2644,8 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
 
     if (!control.Wait())
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
+    if (!mlsagcontrol.Wait())
+        return state.DoS(100, error("%s: MLSAG CheckQueue failed", __func__), REJECT_INVALID, "verify-mlsag-failed");
 
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
@@ -2626,6 +2699,12 @@ bool CChainState::ConnectBlock(const CBlock& block, CValidationState& state, CBl
     if (!pzerocoinDB->WriteCoinSpendBatch(mapSpends)) return state.Error(("Failed to record coin serials to database"));
     if (!pzerocoinDB->WriteCoinMintBatch(mapMints)) return state.Error(("Failed to record new mints to database"));
 
+    // Index this block's pubcoins so that accumulator checkpoints and witnesses do not need to read the block from disk
+    CBlockPubcoins blockPubcoins(pindex->GetBlockHash());
+    for (const auto& pMint : mapMints)
+        blockPubcoins.Add(pMint.first.getDenomination(), pMint.first.getValue());
+    if (!pzerocoinDB->WriteBlockPubcoins(pindex->nHeight, blockPubcoins)) return state.Error(("Failed to record block pubcoins to database"));
+
     //Record accumulator checksums - if they have been updated, which happens every ten blocks
     if (pindex->nHeight > 10 && pindex->nHeight % 10 == 0)
         DatabaseChecksums(mapAccumulators);
@@ -2826,6 +2905,9 @@ bool FlushView(CCoinsViewCache *view, CValidationState& state, bool fDisconnecti
 
         if (!pblocktree->WriteBatch(batch))
             return error("%s: Write RCT outputs failed.", __func__);
+
+        for (auto &it : view->anonOutputs)
+            pblocktree->CacheRCTOutput(it.first, it.second);
     }
 
     view->nLastRCTOutput = 0;
@@ -2958,6 +3040,7 @@ bool CChainState::DisconnectTip(CValidationState& state, const CChainParams& cha
         }
     }
 
+    RemoveChecksumHeights(pindexDelete);
     chainActive.SetTip(pindexDelete->pprev);
     UpdateTip(pindexDelete->pprev, chainparams);
 
@@ -3099,6 +3182,7 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
 
     // Update chainActive & related variables.
     chainActive.SetTip(pindexNew);
+    AddChecksumHeights(pindexNew);
     UpdateTip(pindexNew, chainparams);
 
     int64_t nTime6 = GetTimeMicros(); nTimePostConnect += nTime6 - nTime5; nTimeTotal += nTime6 - nTime1;
@@ -3717,19 +3801,44 @@ static bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos,
     return true;
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckProofOfFullNode = false)
+/**
+ * phashPoW, when given and not null, is taken as the PoW hash of the header instead of running X16R again.
+ * When it is null the computed hash is stored there for the caller.
+ */
+static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckProofOfFullNode = false, uint256* phashPoW = nullptr)
 {
     //Prevent Proof of full node and proof of work existing together
     if (fCheckPOW && fCheckProofOfFullNode)
         return state.DoS(50, false, REJECT_INVALID, "PoW and PoFN conflict", false, "Block attempted to use both PoW and PoFN");
     // Check proof of work matches claimed amount
-    if (fCheckPOW && !CheckProofOfWork(block.GetPoWHash(), block.nBits, consensusParams))
-        return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+    if (fCheckPOW) {
+        uint256 hashPoW = phashPoW && !phashPoW->IsNull() ? *phashPoW : block.GetPoWHash();
+        if (phashPoW)
+            *phashPoW = hashPoW;
+        if (!CheckProofOfWork(hashPoW, block.nBits, consensusParams))
+            return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+    }
 
     return true;
 }
 
-bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot)
+/**
+ * The PoW hash cached in the index entry of an already indexed block. Entries loaded from an older block index
+ * get theirs filled in and written back, so later reindex and verifychain passes skip X16R for them.
+ */
+static uint256 GetIndexedPoWHash(const CBlockHeader& block, CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    if (pindex->GetBlockHash() != block.GetHash())
+        return uint256();
+    if (!(pindex->nStatus & BLOCK_HAVE_POWHASH)) {
+        pindex->SetBlockPoWHash(block.GetPoWHash());
+        setDirtyBlockIndex.insert(pindex);
+    }
+    return pindex->hashPoW;
+}
+
+bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot, CBlockIndex* pindex)
 {
     // These are checks that are independent of context.
     if (block.fChecked)
@@ -3737,7 +3846,11 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
 
     // Check that the header is valid (particularly PoW).  This is mostly
     // redundant with the call in AcceptBlockHeader.
-    if (!CheckBlockHeader(block, state, consensusParams, (fCheckPOW && block.IsProofOfWork()), block.fProofOfFullNode))
+    bool fCheckBlockPoW = fCheckPOW && block.IsProofOfWork();
+    uint256 hashPoW;
+    if (fCheckBlockPoW && pindex && !block.fProofOfFullNode)
+        hashPoW = GetIndexedPoWHash(block, pindex);
+    if (!CheckBlockHeader(block, state, consensusParams, fCheckBlockPoW, block.fProofOfFullNode, &hashPoW))
         return false;
 
     // Check the block signature if it is a proof of stake block
@@ -3776,14 +3889,19 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
             return state.DoS(100, false, REJECT_INVALID, "bad-cb-multiple", false, "more than one coinbase");
     }
 
-    // Check transactions
+    // Check transactions, range proofs are verified in parallel once every transaction has passed the cheap checks.
+    // Proofs already verified on mempool acceptance are found in the range proof cache and dropped from it.
+    std::vector<CRangeProofCheck> vRangeProofChecks;
     for (const auto& tx : block.vtx) {
-        if (!CheckTransaction(*tx, state, false))
+        if (!CheckTransaction(*tx, state, false, nScriptCheckThreads ? &vRangeProofChecks : nullptr, false))
             return state.Invalid(false, state.GetRejectCode(), state.GetRejectReason(),
                                  strprintf("Transaction check failed (tx hash %s) %s", tx->GetHash().ToString(),
                                            state.GetDebugMessage()));
     }
 
+    if (!VerifyRangeProofs(vRangeProofChecks, state))
+        return false; // state filled in by VerifyRangeProofs
+
     unsigned int nSigOps = 0;
     for (const auto& tx : block.vtx)
     {
@@ -3856,14 +3974,14 @@ bool AddZerocoinsToIndex(CBlockIndex* pindex, const CBlock& block, const std::ma
 
     // Track zerocoin money supply
     CAmount nAmountZerocoinSpent = 0;
-    pindex->vMintDenominationsInBlock.clear();
+    pindex->mapMintCounts = CDenominationArray<uint32_t>();
     if (pindex->pprev) {
         std::set<uint256> setAddedToWallet;
         for (auto& pMint : mapMints) {
             const auto& coin = pMint.first;
             const auto& txid = pMint.second;
             libzerocoin::CoinDenomination denom = coin.getDenomination();
-            pindex->vMintDenominationsInBlock.push_back(denom);
+            pindex->mapMintCounts[denom]++;
             pindex->mapZerocoinSupply.at(denom)++;
 
             //Remove any of our own mints from the mintpool
@@ -3913,6 +4031,90 @@ bool ContextualCheckZerocoinMint(const CTransaction& tx, const libzerocoin::Publ
     return true;
 }
 
+/**
+ * Zerocoin spends whose proofs have been verified, to avoid verifying them again when a spend seen in the
+ * mempool is connected, or when a block is reconnected after a reorg. Entries are
+ * SHA256(nonce || spend hash || accumulator checksum) and are never erased on lookup.
+ */
+static CuckooCache::cache<uint256, SignatureCacheHasher> zerocoinSpendCache;
+static uint256 zerocoinSpendCacheNonce(GetRandHash());
+static CCriticalSection cs_zerocoinSpendCache;
+
+void InitZerocoinSpendCache()
+{
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxzcspendcachesize", DEFAULT_MAX_ZCSPEND_CACHE_SIZE)), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = zerocoinSpendCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for zerocoin spend cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+/** Verifies that the coin of spend has been accumulated, using and filling the spend cache */
+static bool CheckZerocoinSpendProof(const libzerocoin::CoinSpend& spend)
+{
+    CBigNum bnAccumulatorValue;
+    if (!pzerocoinDB->ReadAccumulatorValue(spend.getAccumulatorChecksum(), bnAccumulatorValue))
+        return error("%s: Cannot find accumulator checkpoint in zerocoinDB\n", __func__);
+
+    // The checksum commits to the accumulator value, so a spend that verified once against a checksum
+    // that is still known verifies again
+    uint256 hashCacheEntry;
+    uint256 hashSpend = SerializeHash(spend);
+    uint256 hashChecksum = spend.getAccumulatorChecksum();
+    CSHA256().Write(zerocoinSpendCacheNonce.begin(), 32).Write(hashSpend.begin(), 32).Write(hashChecksum.begin(), 32).Finalize(hashCacheEntry.begin());
+    {
+        LOCK(cs_zerocoinSpendCache);
+        if (zerocoinSpendCache.contains(hashCacheEntry, false))
+            return true;
+    }
+
+    libzerocoin::Accumulator accumulator(Params().Zerocoin_Params(), spend.getDenomination(), bnAccumulatorValue);
+
+    //Check that the coin has been accumulated
+    std::string strError;
+    if (!spend.Verify(accumulator, strError, true))
+        return error("CheckZerocoinSpend(): zerocoin spend did not verify");
+
+    LOCK(cs_zerocoinSpendCache);
+    zerocoinSpendCache.insert(hashCacheEntry);
+    return true;
+}
+
+bool PreVerifyZerocoinSpends(const CTransaction& tx, CValidationState& state)
+{
+    // Only spends that would reach the proof check of AcceptToMemoryPool are verified. Anything its cheaper checks
+    // reject, such as a known serial or an unknown accumulator checkpoint, is left to it.
+    std::vector<std::shared_ptr<libzerocoin::CoinSpend>> vSpends;
+    std::set<CBigNum> setSerials;
+    for (const CTxIn& txin : tx.vin) {
+        if (!txin.scriptSig.IsZerocoinSpend())
+            continue;
+        auto spend = TxInToZerocoinSpend(txin);
+        if (!spend || !setSerials.emplace(spend->getCoinSerialNumber()).second)
+            return true;
+
+        CBigNum bnAccumulatorValue;
+        if (!pzerocoinDB->ReadAccumulatorValue(spend->getAccumulatorChecksum(), bnAccumulatorValue))
+            return true;
+
+        {
+            LOCK(cs_main);
+            int nHeightTx;
+            if (IsSerialInBlockchain(spend->getCoinSerialNumber(), nHeightTx, chainActive.Tip()))
+                return true;
+        }
+
+        if (!spend->HasValidSignature())
+            return true;
+        vSpends.emplace_back(spend);
+    }
+
+    for (const auto& spend : vSpends) {
+        if (!CheckZerocoinSpendProof(*spend))
+            return state.DoS(100, false, REJECT_INVALID, "bad-zcspend");
+    }
+    return true;
+}
+
 bool ContextualCheckZerocoinSpend(const CTransaction& tx, const libzerocoin::CoinSpend& spend, const uint256& hashBlock,
         CBlockIndex* pindex, bool fSkipSignatureVerify)
 {
@@ -3940,17 +4142,8 @@ bool ContextualCheckZerocoinSpend(const CTransaction& tx, const libzerocoin::Coi
 
     //Check the signature of the spend
     // Skip signature verification during initial block download
-    if (!fSkipSignatureVerify) {
-        CBigNum bnAccumulatorValue;
-        if (!pzerocoinDB->ReadAccumulatorValue(spend.getAccumulatorChecksum(), bnAccumulatorValue))
-            return error("%s: Cannot find accumulator checkpoint in zerocoinDB\n", __func__);
-        libzerocoin::Accumulator accumulator(Params().Zerocoin_Params(), spend.getDenomination(), bnAccumulatorValue);
-
-        //Check that the coin has been accumulated
-        std::string strError;
-        if (!spend.Verify(accumulator, strError, true))
-            return error("CheckZerocoinSpend(): zerocoin spend did not verify");
-    }
+    if (!fSkipSignatureVerify && !CheckZerocoinSpendProof(spend))
+        return false;
 
     return true;
 }
@@ -4114,7 +4307,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fProofOfStake, bool fProofOfFullNode)
+bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fProofOfStake, bool fProofOfFullNode, uint256 hashPoW)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -4133,7 +4326,7 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
         }
 
         bool fCheckPoW = !block.fProofOfStake;
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPoW, fProofOfFullNode))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPoW, fProofOfFullNode, &hashPoW))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -4165,8 +4358,12 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             }
         }
     }
-    if (pindex == nullptr)
+    if (pindex == nullptr) {
         pindex = AddToBlockIndex(block, fProofOfStake, fProofOfFullNode);
+        // Keep the hash checked above, the block itself will be checked again by AcceptBlock and ConnectBlock
+        if (!hashPoW.IsNull())
+            pindex->SetBlockPoWHash(hashPoW);
+    }
 
     if (ppindex)
         *ppindex = pindex;
@@ -4176,17 +4373,115 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
     return true;
 }
 
+/** Number of consecutive headers hashed by one CHeaderPoWCheck, enough to fill the X16R multi-buffer lanes */
+static const size_t HEADER_POW_CHECK_GROUP = 16;
+
+/**
+ * Closure computing the PoW hashes of a group of headers for ProcessNewBlockHeaders. A hash that does not meet its
+ * nBits fails the check, so the queue skips the remaining groups. The failing header is still reported by
+ * AcceptBlockHeader, which hashes any header left without a hash itself.
+ */
+class CHeaderPoWCheck
+{
+private:
+    std::vector<const CBlockHeader*> vHeaders;
+    std::vector<uint256*> vHashOut;
+    const Consensus::Params* pconsensusParams;
+
+public:
+    CHeaderPoWCheck() : pconsensusParams(nullptr) {}
+    explicit CHeaderPoWCheck(const Consensus::Params& consensusParams) : pconsensusParams(&consensusParams) {}
+
+    void Add(const CBlockHeader* pheader, uint256* phashOut)
+    {
+        vHeaders.push_back(pheader);
+        vHashOut.push_back(phashOut);
+    }
+
+    size_t size() const { return vHeaders.size(); }
+
+    bool operator()()
+    {
+        std::vector<uint256> vHashes;
+        GetPoWHashes(vHeaders, vHashes);
+        for (size_t i = 0; i < vHashes.size(); i++) {
+            if (!CheckProofOfWork(vHashes[i], vHeaders[i]->nBits, *pconsensusParams))
+                return false;
+            *vHashOut[i] = vHashes[i];
+        }
+        return true;
+    }
+
+    void swap(CHeaderPoWCheck& check)
+    {
+        vHeaders.swap(check.vHeaders);
+        vHashOut.swap(check.vHashOut);
+        std::swap(pconsensusParams, check.pconsensusParams);
+    }
+};
+
+static CCheckQueue<CHeaderPoWCheck> headerpowcheckqueue(4);
+
+void ThreadHeaderPoWCheck() {
+    RenameThread("veil-headerpow");
+    headerpowcheckqueue.Thread();
+}
+
+/**
+ * Compute the PoW hashes of all new PoW headers in one go, on the check queue when script check threads
+ * are enabled. PoS, PoFN and already indexed headers get a null hash, and hashing stops early once a
+ * header fails its proof of work.
+ */
+static void ComputeHeadersPoW(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams, std::vector<uint256>& vHashPoW)
+{
+    vHashPoW.assign(headers.size(), uint256());
+
+    std::vector<bool> vKnown(headers.size());
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < headers.size(); i++)
+            vKnown[i] = mapBlockIndex.count(headers[i].GetHash()) != 0;
+    }
+
+    std::vector<CHeaderPoWCheck> vChecks(1, CHeaderPoWCheck(consensusParams));
+    for (size_t i = 0; i < headers.size(); i++) {
+        if (headers[i].fProofOfStake || headers[i].fProofOfFullNode || vKnown[i])
+            continue;
+        if (vChecks.back().size() == HEADER_POW_CHECK_GROUP)
+            vChecks.emplace_back(consensusParams);
+        vChecks.back().Add(&headers[i], &vHashPoW[i]);
+    }
+
+    if (nScriptCheckThreads && vChecks.size() > 1) {
+        CCheckQueueControl<CHeaderPoWCheck> control(&headerpowcheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    } else {
+        for (CHeaderPoWCheck& check : vChecks) {
+            if (!check())
+                break;
+        }
+    }
+}
+
 // Exposed wrapper for AcceptBlockHeader
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+
+    // Proof of work only depends on the header itself, so hash them all before taking cs_main for
+    // the sequential contextual checks
+    std::vector<uint256> vHashPoW;
+    ComputeHeadersPoW(headers, chainparams.GetConsensus(), vHashPoW);
+
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
             bool fProofOfStake = header.fProofOfStake;// todo, no easy way to know if this is PoS block - maybe look at hash value?
             bool fProofOfFullNode = header.fProofOfFullNode;
-            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex, fProofOfStake, fProofOfFullNode)) {
+            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex, fProofOfStake, fProofOfFullNode, vHashPoW[i])) {
                 if (first_invalid) *first_invalid = header;
                 return false;
             }
@@ -4309,7 +4604,7 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
         if (pindex->nChainWork < nMinimumChainWork) return true;
     }
 
-    if (!CheckBlock(block, state, chainparams.GetConsensus()) ||
+    if (!CheckBlock(block, state, chainparams.GetConsensus(), true, true, pindex) ||
         !ContextualCheckBlock(block, state, chainparams.GetConsensus(), pindex->pprev)) {
         if (state.IsInvalid() && !state.CorruptionPossible()) {
             pindex->nStatus |= BLOCK_FAILED_VALID;
@@ -4678,6 +4973,7 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
             pindexBestInvalid = pindex;
         if (pindex->pprev)
             pindex->BuildSkip();
+        pindex->LoadAccumulatorHashes();
         if (pindex->IsValid(BLOCK_VALID_TREE) && (pindexBestHeader == nullptr || CBlockIndexWorkComparator()(pindexBestHeader, pindex)))
             pindexBestHeader = pindex;
     }
@@ -4761,6 +5057,7 @@ bool LoadChainTip(const CChainParams& chainparams)
         return false;
     }
     chainActive.SetTip(pindex);
+    LoadChecksumHeights(chainActive);
 
     g_chainstate.PruneBlockIndexCandidates();
 
@@ -4822,7 +5119,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
         if (!ReadBlockFromDisk(block, pindex, chainparams.GetConsensus()))
             return error("VerifyDB(): *** ReadBlockFromDisk failed at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
         // check level 1: verify block validity
-        if (nCheckLevel >= 1 && !CheckBlock(block, state, chainparams.GetConsensus()))
+        if (nCheckLevel >= 1 && !CheckBlock(block, state, chainparams.GetConsensus(), true, true, pindex))
             return error("%s: *** found bad block at %d, hash=%s (%s)\n", __func__,
                          pindex->nHeight, pindex->GetBlockHash().ToString(), FormatStateMessage(state));
         // check level 2: verify undo validity
@@ -5118,6 +5415,7 @@ void UnloadBlockIndex()
 {
     LOCK(cs_main);
     chainActive.SetTip(nullptr);
+    LoadChecksumHeights(chainActive);
     pindexBestInvalid = nullptr;
     pindexBestHeader = nullptr;
     mempool.clear();
@@ -83,6 +83,10 @@ static const unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
 static const int MAX_SCRIPTCHECK_THREADS = 16;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** Header proof of work hashing only has work while syncing headers, so it uses at most this many threads */
+static const int MAX_HEADERPOWCHECK_THREADS = 2;
+/** Default for -maxzcspendcachesize, size of the verified zerocoin spend cache in MiB */
+static const unsigned int DEFAULT_MAX_ZCSPEND_CACHE_SIZE = 2;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
@@ -268,6 +272,12 @@ bool LoadChainTip(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the MLSAG ring signature checking thread */
+void ThreadMLSAGCheck();
+/** Run an instance of the range proof checking thread */
+void ThreadRangeProofCheck();
+/** Run an instance of the header proof of work hashing thread */
+void ThreadHeaderPoWCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
@@ -364,6 +374,15 @@ bool TestLockPointValidity(const LockPoints* lp);
  */
 bool CheckSequenceLocks(const CTransaction &tx, int flags, LockPoints* lp = nullptr, bool useExistingLockPoints = false);
 
+/** Initializes the verified zerocoin spend cache */
+void InitZerocoinSpendCache();
+/**
+ * Verifies the proofs of the zerocoin spends of tx into the spend cache. It only takes cs_main for short lookups, so
+ * callers of AcceptToMemoryPool can do the expensive part of checking a spend before taking the lock. Spends that
+ * AcceptToMemoryPool would reject before verifying their proofs are skipped. Returns false, with a DoS score in state,
+ * if a proof fails to verify.
+ */
+bool PreVerifyZerocoinSpends(const CTransaction& tx, CValidationState& state);
 bool ContextualCheckZerocoinSpend(const CTransaction& tx, const libzerocoin::CoinSpend& spend, const uint256& hashBlock, CBlockIndex* pindex, bool fSkipSignatureVerify = false);
 bool ContextualCheckZerocoinMint(const CTransaction& tx, const libzerocoin::PublicCoin& coin, CBlockIndex* pindex);
 
@@ -419,8 +438,8 @@ bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CBlockIndex* pindex
 
 /** Functions for validating blocks and updating the block tree */
 
-/** Context-independent validity checks */
-bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true);
+/** Context-independent validity checks. pindex, when the block is already indexed, supplies a previously computed PoW hash. */
+bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true, CBlockIndex* pindex = nullptr);
 
 /** Check a block is completely valid from start to finish (only works on top of our current best block) */
 bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW = true, bool fCheckMerkleRoot = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -7,12 +7,14 @@
 #include <random>
 #include <tinyformat.h>
 #include "arith_uint256.h"
+#include "clientversion.h"
 #include "consensus/merkle.h"
 #include "veil/proofofstake/kernel.h"
 #include "key_io.h"
 #include "net_processing.h"
 #include "primitives/block.h"
 #include "script/standard.h"
+#include "streams.h"
 #include "utilstrencodings.h"
 #include "validation.h"
 #include "veil/zerocoin/zchain.h"
@@ -29,6 +31,63 @@ uint256 GetFullNodeHash(const CBlock& block, const CBlockIndex* pindexPrev)
     return hashOut;
 }
 
+bool GetProofOfFullNodeRound(CDataStream& ssBlock, const uint256& hashBlock, const uint256& hashCommitToChain,
+                             uint32_t nCommitNumber, uint256& hashMutatedRoot)
+{
+    // Only the txids are needed, so walk the serialized transactions instead of building a CBlock
+    std::vector<uint256> vTxid;
+    CMutableTransaction txMutate;
+    try {
+        CBlockHeader header;
+        ssBlock >> header;
+        if (header.GetHash() != hashBlock)
+            return error("%s: block hash %s does not match %s", __func__, header.GetHash().GetHex(), hashBlock.GetHex());
+
+        uint64_t nTx = ReadCompactSize(ssBlock);
+        if (nTx == 0)
+            return error("%s: block %s has no transactions", __func__, hashBlock.GetHex());
+
+        //Get data from the block that a full node would have
+        uint32_t nRandTx = nCommitNumber % nTx;
+        vTxid.reserve(nTx + 1);
+        for (uint64_t i = 0; i < nTx; i++) {
+            CMutableTransaction tx(deserialize, ssBlock);
+            vTxid.emplace_back(tx.GetHash());
+            if (i == nRandTx)
+                txMutate = std::move(tx);
+        }
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize error - %s", __func__, e.what());
+    }
+
+    // Mutate the transaction and get a new hash
+    for (auto& txin : txMutate.vin)
+        txin.nSequence = nCommitNumber;
+    uint256 hashMutatedTx = txMutate.GetHash();
+
+    // Strengthen commitment to owner, chain, and mutation
+    uint256 seed = Hash(hashMutatedTx.begin(), hashMutatedTx.end(), hashCommitToChain.begin(), hashCommitToChain.end());
+
+    // Use the seed to randomly shuffle the block's transactions and construct a mutated merkle root that contains
+    // mutated tx. Txids below the seed go in front in reverse order, the rest follow in block order.
+    vTxid.emplace_back(hashMutatedTx);
+    std::vector<uint256> vLeaves;
+    vLeaves.reserve(vTxid.size());
+    for (auto it = vTxid.rbegin(); it != vTxid.rend(); ++it) {
+        if (*it < seed)
+            vLeaves.emplace_back(*it);
+    }
+    for (const uint256& txid : vTxid) {
+        if (!(txid < seed))
+            vLeaves.emplace_back(txid);
+    }
+
+    // Bind with mutated merkle root
+    hashMutatedRoot = ComputeMerkleRoot(std::move(vLeaves));
+    hashMutatedRoot = Hash(hashMutatedRoot.begin(), hashMutatedRoot.end(), seed.begin(), seed.end());
+    return true;
+}
+
 //! Construct a hash that challenges the owner of the block to prove they are a full node by grabbing a deterministic
 //!  psuedo-random previous block, and reording the transactions to construct a new merkle tree
 bool GenerateProofOfFullNodeVector(const uint256& hashUniqueToOwner, const uint256& hashUniqueToBlock,
@@ -47,40 +106,14 @@ bool GenerateProofOfFullNodeVector(const uint256& hashUniqueToOwner, const uint2
         auto pindexCheck = pindexPrev->GetAncestor(nHeightBlockCheck);
         if (!pindexCheck)
             return error("%s: do not have ancestor block at height %d", __func__, nHeightBlockCheck);
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindexCheck, Params().GetConsensus()))
+        std::vector<uint8_t> vchBlock;
+        if (!ReadRawBlockFromDisk(vchBlock, pindexCheck, Params().MessageStart()))
             return false;
 
-        //Get data from the block that a full node would have
-        uint32_t nRandTx = nCommitNumber % block.vtx.size();
-        nRandTx = std::min(nRandTx, (uint32_t)block.vtx.size() - 1);
-        CMutableTransaction txMutate(*block.vtx[nRandTx]);
-
-        // Mutate the transaction and get a new hash
-        for (auto& txin : txMutate.vin)
-            txin.nSequence = nCommitNumber;
-        uint256 hashMutatedTx = txMutate.GetHash();
-      //  LogPrintf("%s: hashMutatedTx=%s\n", __func__, hashMutatedTx.GetHex());
-
-        // Strengthen commitment to owner, chain, and mutation
-        uint256 seed = Hash(hashMutatedTx.begin(), hashMutatedTx.end(), hashCommitToChain.begin(), hashCommitToChain.end());
-        //LogPrintf("%s: seed=%s\n", __func__, seed.GetHex());
-        // Use the seed to randomly shuffle the block's transactions and construct a mutated merkle root that contains mutated tx
-        CTransaction tx(txMutate);
-        block.vtx.emplace_back(MakeTransactionRef(tx));
-        auto vtxMutate = block.vtx;
-        vtxMutate.clear();
-        for (auto& t : block.vtx) {
-            if (t->GetHash() < seed)
-                vtxMutate.insert(vtxMutate.begin(), t);
-            else
-                vtxMutate.emplace_back(t);
-        }
-        block.vtx = vtxMutate;
-
-        // Bind with mutated merkle root
-        uint256 hashMutatedRoot = BlockMerkleRoot(block);
-        hashMutatedRoot = Hash(hashMutatedRoot.begin(), hashMutatedRoot.end(), seed.begin(), seed.end());
+        CDataStream ssBlock(vchBlock, SER_DISK, CLIENT_VERSION);
+        uint256 hashMutatedRoot;
+        if (!GetProofOfFullNodeRound(ssBlock, pindexCheck->GetBlockHash(), hashCommitToChain, nCommitNumber, hashMutatedRoot))
+            return false;
         //LogPrintf("%s: hashMutatedRoot=%s\n", __func__, hashMutatedRoot.GetHex());
         vProofs.emplace_back(hashMutatedRoot);
         nHeightBlockCheck = UintToArith256(hashMutatedRoot).GetLow32() % pindexPrev->nHeight;
@@ -91,5 +124,4 @@ bool GenerateProofOfFullNodeVector(const uint256& hashUniqueToOwner, const uint2
     return true;
 }
 
-
 }
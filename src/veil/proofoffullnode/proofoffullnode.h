@@ -8,6 +8,7 @@
 
 #include "chain.h"
 #include "chainparams.h"
+#include "streams.h"
 
 class CBlock;
 extern CCriticalSection cs_main;
@@ -16,6 +17,14 @@ namespace veil {
 
 uint256 GetFullNodeHash(const CBlock& block, const CBlockIndex* prev) ASSERT_EXCLUSIVE_LOCK(cs_main);
 
+/**
+ * One round of the proof of full node over a serialized block whose header hashes to hashBlock. Reads the txids,
+ * mutates the transaction selected by nCommitNumber and sets hashMutatedRoot to the merkle root of the reordered
+ * txids bound to the round's seed. Returns false if the block cannot be read.
+ */
+bool GetProofOfFullNodeRound(CDataStream& ssBlock, const uint256& hashBlock, const uint256& hashCommitToChain,
+                             uint32_t nCommitNumber, uint256& hashMutatedRoot);
+
 /**
  * Generates a proof of full node signature vector. Returns false if the proof fails.
  */
@@ -9,6 +9,8 @@
 #include <boost/foreach.hpp>
 
 #include "chainparams.h"
+#include "checkqueue.h"
+#include "crypto/common.h"
 #include "db.h"
 #include "kernel.h"
 #include "policy/policy.h"
@@ -19,31 +21,63 @@
 #include "veil/zerocoin/zchain.h"
 #include "libzerocoin/bignum.h"
 
+#include <atomic>
+
 using namespace std;
 
-//test hash vs target
-bool stakeTargetHit(arith_uint256 hashProofOfStake, int64_t nValueIn, arith_uint256 bnTargetPerCoinDay)
+//get the stake weight - weight is equal to coin amount
+static arith_uint256 GetWeightedTarget(int64_t nValueIn, const arith_uint256& bnTargetPerCoinDay)
 {
-    //get the stake weight - weight is equal to coin amount
     arith_uint256 bnTarget = arith_uint256(nValueIn) * bnTargetPerCoinDay;
 
     //Double check for overflow, give max value if overflow
     if (bnTargetPerCoinDay > bnTarget)
         bnTarget = ~arith_uint256();
 
+    return bnTarget;
+}
+
+//test hash vs target
+bool stakeTargetHit(arith_uint256 hashProofOfStake, int64_t nValueIn, arith_uint256 bnTargetPerCoinDay)
+{
     // Now check if proof-of-stake hash meets target protocol
-    return hashProofOfStake < bnTarget;
+    return hashProofOfStake < GetWeightedTarget(nValueIn, bnTargetPerCoinDay);
 }
 
-bool CheckStake(const CDataStream& ssUniqueID, CAmount nValueIn, const uint64_t nStakeModifier, const uint256& bnTarget,
-                unsigned int nTimeBlockFrom, unsigned int& nTimeTx, uint256& hashProofOfStake)
+CStakeKernel::CStakeKernel(const CDataStream& ssUniqueID, CAmount nValueIn, uint64_t nStakeModifier, const arith_uint256& bnTargetPerCoinDay, unsigned int nTimeBlockFrom)
 {
     CDataStream ss(SER_GETHASH, 0);
-    ss << nStakeModifier << nTimeBlockFrom << ssUniqueID << nTimeTx;
-    hashProofOfStake = Hash(ss.begin(), ss.end());
-    //LogPrintf("%s: modifier:%d nTimeBlockFrom:%d nTimeTx:%d hash:%s\n", __func__, nStakeModifier, nTimeBlockFrom, nTimeTx, hashProofOfStake.GetHex());
+    ss << nStakeModifier << nTimeBlockFrom << ssUniqueID;
+    hasherPrefix.Write((const unsigned char*)ss.data(), ss.size());
+    bnTarget = GetWeightedTarget(nValueIn, bnTargetPerCoinDay);
+}
 
-    return stakeTargetHit(UintToArith256(hashProofOfStake), nValueIn, UintToArith256(bnTarget));
+bool CStakeKernel::CheckTime(unsigned int nTimeTx, uint256& hashProofOfStake) const
+{
+    unsigned char vchTime[4];
+    WriteLE32(vchTime, nTimeTx);
+    CHash256(hasherPrefix).Write(vchTime, sizeof(vchTime)).Finalize(hashProofOfStake.begin());
+
+    return UintToArith256(hashProofOfStake) < bnTarget;
+}
+
+bool CStakeKernel::Search(unsigned int nTimeTx, unsigned int& nTimeTxOut, uint256& hashProofOfStake) const
+{
+    for (int i = 0; i < STAKE_HASH_DRIFT; i++) {
+        unsigned int nTryTime = nTimeTx + STAKE_HASH_DRIFT - i;
+        if (CheckTime(nTryTime, hashProofOfStake)) {
+            nTimeTxOut = nTryTime;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CheckStake(const CDataStream& ssUniqueID, CAmount nValueIn, const uint64_t nStakeModifier, const uint256& bnTarget,
+                unsigned int nTimeBlockFrom, unsigned int& nTimeTx, uint256& hashProofOfStake)
+{
+    CStakeKernel kernel(ssUniqueID, nValueIn, nStakeModifier, UintToArith256(bnTarget), nTimeBlockFrom);
+    return kernel.CheckTime(nTimeTx, hashProofOfStake);
 }
 
 
@@ -62,8 +96,13 @@ void WeightStake(CAmount& nValueIn, const libzerocoin::CoinDenomination denom)
     }
 }
 
-bool Stake(CStakeInput* stakeInput, unsigned int nBits, unsigned int nTimeBlockFrom, unsigned int& nTimeTx, uint256& hashProofOfStake)
+bool GetStakeKernel(CStakeInput* stakeInput, unsigned int nBits, unsigned int nTimeTx, CStakeKernel& kernel)
 {
+    CBlockIndex* pindexFrom = stakeInput->GetIndexFrom();
+    if (!pindexFrom)
+        return error("%s: failed to find the block index", __func__);
+    unsigned int nTimeBlockFrom = pindexFrom->GetBlockTime();
+
     if (nTimeTx < nTimeBlockFrom)
         return error("Stake() : nTime violation");
 
@@ -80,37 +119,99 @@ bool Stake(CStakeInput* stakeInput, unsigned int nBits, unsigned int nTimeBlockF
     if (!stakeInput->GetModifier(nStakeModifier))
         return error("failed to get kernel stake modifier");
 
-    bool fSuccess = false;
-    unsigned int nTryTime = 0;
-    int nHeightStart = chainActive.Height();
-    int nHashDrift = 30;
-    CDataStream ssUniqueID = stakeInput->GetUniqueness();
     CAmount nValueIn = stakeInput->GetValue();
 
     //Adjust stake weights to larger denoms
     WeightStake(nValueIn, stakeInput->GetDenomination());
 
-    for (int i = 0; i < nHashDrift; i++) //iterate the hashing
+    kernel = CStakeKernel(stakeInput->GetUniqueness(), nValueIn, nStakeModifier, bnTargetPerCoinDay, nTimeBlockFrom);
+    return true;
+}
+
+/** Number of kernels scanned by one CStakeKernelCheck */
+static const size_t STAKE_KERNEL_CHECK_GROUP = 64;
+
+/**
+ * Closure scanning a range of kernels for FindStakeKernel. It stops at the first hit or once an earlier kernel
+ * has hit, and records hits in the per-kernel result slots, so it always succeeds as far as the queue is concerned.
+ */
+class CStakeKernelCheck
+{
+private:
+    const std::vector<CStakeKernel>* pvKernels;
+    size_t nBegin;
+    size_t nEnd;
+    unsigned int nTimeTx;
+    std::atomic<size_t>* pnFound;
+    std::vector<unsigned int>* pvTimeTx;
+    std::vector<uint256>* pvHashProofOfStake;
+
+public:
+    CStakeKernelCheck() : pvKernels(nullptr), nBegin(0), nEnd(0), nTimeTx(0), pnFound(nullptr), pvTimeTx(nullptr), pvHashProofOfStake(nullptr) {}
+    CStakeKernelCheck(const std::vector<CStakeKernel>* pvKernelsIn, size_t nBeginIn, size_t nEndIn, unsigned int nTimeTxIn,
+                      std::atomic<size_t>* pnFoundIn, std::vector<unsigned int>* pvTimeTxIn, std::vector<uint256>* pvHashProofOfStakeIn) :
+        pvKernels(pvKernelsIn), nBegin(nBeginIn), nEnd(nEndIn), nTimeTx(nTimeTxIn), pnFound(pnFoundIn), pvTimeTx(pvTimeTxIn),
+        pvHashProofOfStake(pvHashProofOfStakeIn) {}
+
+    bool operator()()
     {
-        //new block came in, move on
-        if (chainActive.Height() != nHeightStart)
+        for (size_t i = nBegin; i < nEnd && i < *pnFound; i++) {
+            if (!(*pvKernels)[i].Search(nTimeTx, (*pvTimeTx)[i], (*pvHashProofOfStake)[i]))
+                continue;
+            // Keep the lowest index so the result does not depend on scheduling
+            size_t nFound = *pnFound;
+            while (i < nFound && !pnFound->compare_exchange_weak(nFound, i)) {}
             break;
+        }
+        return true;
+    }
 
-        //hash this iteration
-        nTryTime = nTimeTx + nHashDrift - i;
+    void swap(CStakeKernelCheck& check)
+    {
+        std::swap(pvKernels, check.pvKernels);
+        std::swap(nBegin, check.nBegin);
+        std::swap(nEnd, check.nEnd);
+        std::swap(nTimeTx, check.nTimeTx);
+        std::swap(pnFound, check.pnFound);
+        std::swap(pvTimeTx, check.pvTimeTx);
+        std::swap(pvHashProofOfStake, check.pvHashProofOfStake);
+    }
+};
+
+static CCheckQueue<CStakeKernelCheck> stakekernelcheckqueue(1);
+
+void ThreadStakeKernelCheck() {
+    RenameThread("veil-stakekernel");
+    stakekernelcheckqueue.Thread();
+}
 
-        // if stake hash does not meet the target then continue to next iteration
-        if (!CheckStake(ssUniqueID, nValueIn, nStakeModifier, ArithToUint256(bnTargetPerCoinDay), nTimeBlockFrom, nTryTime, hashProofOfStake))
-            continue;
+size_t FindStakeKernel(const std::vector<CStakeKernel>& vKernels, size_t nStart, unsigned int nTimeTx, unsigned int& nTimeTxOut, uint256& hashProofOfStake)
+{
+    std::atomic<size_t> nFound(vKernels.size());
+    std::vector<unsigned int> vTimeTx(vKernels.size());
+    std::vector<uint256> vHashProofOfStake(vKernels.size());
+
+    std::vector<CStakeKernelCheck> vChecks;
+    for (size_t i = nStart; i < vKernels.size(); i += STAKE_KERNEL_CHECK_GROUP) {
+        size_t nEnd = std::min(i + STAKE_KERNEL_CHECK_GROUP, vKernels.size());
+        vChecks.emplace_back(&vKernels, i, nEnd, nTimeTx, &nFound, &vTimeTx, &vHashProofOfStake);
+    }
 
-        fSuccess = true; // if we make it this far then we have successfully created a stake hash
-        nTimeTx = nTryTime;
-        break;
+    if (nScriptCheckThreads && vChecks.size() > 1) {
+        CCheckQueueControl<CStakeKernelCheck> control(&stakekernelcheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    } else {
+        for (CStakeKernelCheck& check : vChecks)
+            check();
     }
 
-    mapHashedBlocks.clear();
-    mapHashedBlocks[chainActive.Tip()->nHeight] = GetTime(); //store a time stamp of when we last hashed on this block
-    return fSuccess;
+    size_t nIndex = nFound;
+    if (nIndex < vKernels.size()) {
+        nTimeTxOut = vTimeTx[nIndex];
+        hashProofOfStake = vHashProofOfStake[nIndex];
+    }
+    return nIndex;
 }
 
 // Check kernel hash target and coinstake signature
@@ -136,11 +237,6 @@ bool CheckProofOfStake(const CTransactionRef txRef, const uint32_t& nBits, const
     if (!pindex)
         return error("%s: Failed to find the block index", __func__);
 
-    // Read block header
-    CBlock blockprev;
-    if (!ReadBlockFromDisk(blockprev, pindex->GetBlockPos(), Params().GetConsensus()))
-        return error("CheckProofOfStake(): INFO: failed to find block");
-
     arith_uint256 bnTargetPerCoinDay;
     bnTargetPerCoinDay.SetCompact(nBits);
 
@@ -148,7 +244,7 @@ bool CheckProofOfStake(const CTransactionRef txRef, const uint32_t& nBits, const
     if (!stake->GetModifier(nStakeModifier))
         return error("%s failed to get modifier for stake input\n", __func__);
 
-    unsigned int nBlockFromTime = blockprev.nTime;
+    unsigned int nBlockFromTime = pindex->GetBlockTime();
     unsigned int nTxTime = nTimeBlock;
     if (!CheckStake(stake->GetUniqueness(), stake->GetValue(), nStakeModifier, ArithToUint256(bnTargetPerCoinDay), nBlockFromTime,
                     nTxTime, hashProofOfStake)) {
@@ -6,12 +6,48 @@
 #ifndef BITCOIN_KERNEL_H
 #define BITCOIN_KERNEL_H
 
+#include "hash.h"
 #include "validation.h"
 #include "stakeinput.h"
 
+/** Number of timestamps after nTimeTx tried for every stake input */
+static const int STAKE_HASH_DRIFT = 30;
+
+/**
+ * Kernel hash of one stake input. The constant prefix (stake modifier, nTimeBlockFrom and uniqueness) is hashed
+ * once, so every candidate nTimeTx only costs the SHA256 of its last four bytes on top of the saved midstate.
+ */
+class CStakeKernel
+{
+private:
+    CHash256 hasherPrefix;
+    arith_uint256 bnTarget;
+
+public:
+    CStakeKernel() {}
+    CStakeKernel(const CDataStream& ssUniqueID, CAmount nValueIn, uint64_t nStakeModifier, const arith_uint256& bnTargetPerCoinDay, unsigned int nTimeBlockFrom);
+
+    /** Compute the kernel hash for nTimeTx and check it against the weighted target */
+    bool CheckTime(unsigned int nTimeTx, uint256& hashProofOfStake) const;
+
+    /** Try the STAKE_HASH_DRIFT timestamps after nTimeTx, latest first, setting nTimeTxOut on a hit */
+    bool Search(unsigned int nTimeTx, unsigned int& nTimeTxOut, uint256& hashProofOfStake) const;
+};
+
+/** Prepare the kernel of stakeInput for a block with nBits staked at nTimeTx, false if the input cannot stake */
+bool GetStakeKernel(CStakeInput* stakeInput, unsigned int nBits, unsigned int nTimeTx, CStakeKernel& kernel);
+
+/**
+ * Find the first kernel at or after nStart that hits its target, scanning the kernels on the stake kernel
+ * check queue. Returns its index, with nTimeTxOut and hashProofOfStake set, or vKernels.size() if none hit.
+ */
+size_t FindStakeKernel(const std::vector<CStakeKernel>& vKernels, size_t nStart, unsigned int nTimeTx, unsigned int& nTimeTxOut, uint256& hashProofOfStake);
+
+/** Run an instance of the stake kernel search thread */
+void ThreadStakeKernelCheck();
+
 bool CheckStake(const CDataStream& ssUniqueID, CAmount nValueIn, const uint64_t nStakeModifier, const uint256& bnTarget, unsigned int nTimeBlockFrom, unsigned int& nTimeTx, uint256& hashProofOfStake);
 bool stakeTargetHit(arith_uint256 hashProofOfStake, int64_t nValueIn, arith_uint256 bnTargetPerCoinDay);
-bool Stake(CStakeInput* stakeInput, unsigned int nBits, unsigned int nTimeBlockFrom, unsigned int& nTimeTx, uint256& hashProofOfStake);
 bool CheckProofOfStake(const CTransactionRef txRef, const uint32_t& nBits, const unsigned int& nTimeBlock, uint256& hashProofOfStake, std::unique_ptr<CStakeInput>& stake);
 
 #endif // BITCOIN_KERNEL_H
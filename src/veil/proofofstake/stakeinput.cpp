@@ -25,24 +25,68 @@ ZerocoinStake::ZerocoinStake(const libzerocoin::CoinSpend& spend)
     fMint = false;
 }
 
-int ZerocoinStake::GetChecksumHeightFromMint()
+uint256 ZerocoinStake::GetChecksum()
 {
-    int nHeightChecksum = chainActive.Height() + 1 - Params().Zerocoin_RequiredStakeDepth();
-    //Need to return the first occurance of this checksum in order for the validation process to identify a specific
-    //block height
-    uint256 nChecksum;
-    nChecksum = chainActive[nHeightChecksum]->mapAccumulatorHashes[denom];
-    return GetChecksumHeight(nChecksum, denom);
+    return nChecksum;
 }
 
-int ZerocoinStake::GetChecksumHeightFromSpend()
+/**
+ * Block-from data of an accumulator checksum: the block where it first appears and the stake modifier derived from
+ * it. Neither depends on the serial, so every stake input using the same denomination and checksum shares an entry.
+ * Entries are checked against chainActive when used, so they only go stale after a reorg below their height.
+ */
+struct CStakeIndexFrom
+{
+    uint256 hashBlockFrom;
+    int nHeightFrom;
+    uint64_t nStakeModifier;
+    bool fHaveModifier;
+};
+
+/** Drop the whole cache once it holds this many checksums */
+static const size_t MAX_STAKE_INDEX_FROM_CACHE = 10000;
+
+static CCriticalSection cs_stakeindexfrom;
+static std::map<std::pair<libzerocoin::CoinDenomination, uint256>, CStakeIndexFrom> mapStakeIndexFrom;
+
+static bool GetCachedIndexFrom(libzerocoin::CoinDenomination denom, const uint256& hashChecksum, CStakeIndexFrom& indexFrom)
 {
-    return GetChecksumHeight(nChecksum, denom);
+    LOCK(cs_stakeindexfrom);
+    auto it = mapStakeIndexFrom.find(std::make_pair(denom, hashChecksum));
+    if (it == mapStakeIndexFrom.end())
+        return false;
+
+    const CBlockIndex* pindex = chainActive[it->second.nHeightFrom];
+    if (!pindex || pindex->GetBlockHash() != it->second.hashBlockFrom) {
+        mapStakeIndexFrom.erase(it);
+        return false;
+    }
+
+    indexFrom = it->second;
+    return true;
 }
 
-uint256 ZerocoinStake::GetChecksum()
+static void CacheIndexFrom(libzerocoin::CoinDenomination denom, const uint256& hashChecksum, const CStakeIndexFrom& indexFrom)
 {
-    return nChecksum;
+    LOCK(cs_stakeindexfrom);
+    if (mapStakeIndexFrom.size() >= MAX_STAKE_INDEX_FROM_CACHE)
+        mapStakeIndexFrom.clear();
+    mapStakeIndexFrom[std::make_pair(denom, hashChecksum)] = indexFrom;
+}
+
+// A spend uses its own checksum, a mint the one at the required stake depth below the next block
+bool ZerocoinStake::GetIndexFromChecksum(uint256& hashChecksum)
+{
+    if (!fMint) {
+        hashChecksum = nChecksum;
+        return true;
+    }
+
+    CBlockIndex* pindexChecksum = chainActive[chainActive.Height() + 1 - Params().Zerocoin_RequiredStakeDepth()];
+    if (!pindexChecksum)
+        return false;
+    hashChecksum = pindexChecksum->GetAccumulatorHash(denom);
+    return true;
 }
 
 // The zPIV block index is the first appearance of the accumulator checksum that was used in the spend
@@ -53,12 +97,17 @@ CBlockIndex* ZerocoinStake::GetIndexFrom()
     if (pindexFrom)
         return pindexFrom;
 
-    int nHeightChecksum = 0;
+    uint256 hashChecksum;
+    if (!GetIndexFromChecksum(hashChecksum))
+        return nullptr;
 
-    if (fMint)
-        nHeightChecksum = GetChecksumHeightFromMint();
-    else
-        nHeightChecksum = GetChecksumHeightFromSpend();
+    CStakeIndexFrom indexFrom;
+    if (GetCachedIndexFrom(denom, hashChecksum, indexFrom)) {
+        pindexFrom = chainActive[indexFrom.nHeightFrom];
+        return pindexFrom;
+    }
+
+    int nHeightChecksum = GetChecksumHeight(hashChecksum, denom);
 
     if (nHeightChecksum > chainActive.Height()) {
         pindexFrom = nullptr;
@@ -67,6 +116,15 @@ CBlockIndex* ZerocoinStake::GetIndexFrom()
         pindexFrom = chainActive[nHeightChecksum];
     }
 
+    // A height of 0 means the checksum was not found, which may change as the chain grows
+    if (pindexFrom && nHeightChecksum > 0) {
+        indexFrom.hashBlockFrom = pindexFrom->GetBlockHash();
+        indexFrom.nHeightFrom = nHeightChecksum;
+        indexFrom.nStakeModifier = 0;
+        indexFrom.fHaveModifier = false;
+        CacheIndexFrom(denom, hashChecksum, indexFrom);
+    }
+
     return pindexFrom;
 }
 
@@ -90,6 +148,15 @@ bool ZerocoinStake::GetModifier(uint64_t& nStakeModifier)
         return false;
 
 
+    uint256 hashChecksum;
+    CStakeIndexFrom indexFrom;
+    bool fCached = GetIndexFromChecksum(hashChecksum) && GetCachedIndexFrom(denom, hashChecksum, indexFrom) &&
+                   indexFrom.hashBlockFrom == pindex->GetBlockHash();
+    if (fCached && indexFrom.fHaveModifier) {
+        nStakeModifier = indexFrom.nStakeModifier;
+        return true;
+    }
+
     int nNearest100Block = ZerocoinStake::HeightToModifierHeight(pindex->nHeight);
 
     //Rare case block index < 100, we don't use proof of stake for these blocks
@@ -98,11 +165,14 @@ bool ZerocoinStake::GetModifier(uint64_t& nStakeModifier)
         return false;
     }
 
-    while (nNearest100Block != pindex->nHeight) {
-        pindex = pindex->pprev;
-    }
+    pindex = pindex->GetAncestor(nNearest100Block);
+    nStakeModifier = UintToArith256(pindex->GetAccumulatorHash(denom)).GetLow64();
 
-    nStakeModifier = UintToArith256(pindex->mapAccumulatorHashes[denom]).GetLow64();
+    if (fCached) {
+        indexFrom.nStakeModifier = nStakeModifier;
+        indexFrom.fHaveModifier = true;
+        CacheIndexFrom(denom, hashChecksum, indexFrom);
+    }
     return true;
 }
 
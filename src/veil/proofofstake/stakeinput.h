@@ -46,6 +46,8 @@ private:
     bool fMint;
     uint256 hashSerial;
 
+    bool GetIndexFromChecksum(uint256& hashChecksum);
+
 public:
     explicit ZerocoinStake(libzerocoin::CoinDenomination denom, const uint256& hashSerial)
     {
@@ -66,8 +68,6 @@ public:
     bool CreateTxOuts(CWallet* pwallet, std::vector<CTxOut>& vout, CAmount nTotal) override;
     bool MarkSpent(CWallet* pwallet, const uint256& txid);
     bool IsZerocoins() override { return true; }
-    int GetChecksumHeightFromMint();
-    int GetChecksumHeightFromSpend();
     uint256 GetChecksum();
 
     static int HeightToModifierHeight(int nHeight);
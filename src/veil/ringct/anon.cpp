@@ -17,10 +17,103 @@
 #include <consensus/validation.h>
 #include <chainparams.h>
 #include <txmempool.h>
+#include <cuckoocache.h>
+#include <crypto/sha256.h>
+#include <random.h>
+#include <script/sigcache.h>
 
+#include <atomic>
+#include <boost/thread.hpp>
 
-bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
+
+bool CMLSAGCheck::operator()()
 {
+    const CTxIn &txin = ptxTo->vin.at(nIn);
+    const std::vector<uint8_t> &vKeyImages = txin.scriptData.stack[0];
+    const std::vector<uint8_t> &vDL = txin.scriptWitness.stack[1];
+
+    error = secp256k1_verify_mlsag(secp256k1_ctx_blind, hashOutputs.begin(), nCols, nRows, &vM[0], &vKeyImages[0],
+            &vDL[0], &vDL[32]);
+    return error == 0;
+}
+
+namespace {
+/**
+ * Valid MLSAG cache, to avoid reading the ring members and verifying the ring signatures
+ * of an anon transaction twice (once when accepted into memory pool, and again when accepted
+ * into the block chain)
+ */
+class CMLSAGCache
+{
+private:
+    //! Entries are SHA256(nonce || wtxid || anon output erase count)
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_mlsagcache;
+
+public:
+    std::atomic<uint64_t> nHits{0};
+    std::atomic<uint64_t> nMisses{0};
+
+    CMLSAGCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    void ComputeEntry(uint256& entry, const uint256& wtxid, uint64_t nEraseCount)
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(wtxid.begin(), 32).Write((unsigned char*)&nEraseCount, sizeof(nEraseCount)).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry, const bool erase)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_mlsagcache);
+        return setValid.contains(entry, erase);
+    }
+
+    void Set(uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_mlsagcache);
+        setValid.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        return setValid.setup_bytes(n);
+    }
+};
+
+static CMLSAGCache mlsagCache;
+} // namespace
+
+void InitMLSAGCache()
+{
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxmlsagcachesize", DEFAULT_MAX_MLSAG_CACHE_SIZE)), MAX_MAX_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = mlsagCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for MLSAG cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+void GetMLSAGCacheStats(uint64_t &nHits, uint64_t &nMisses)
+{
+    nHits = mlsagCache.nHits;
+    nMisses = mlsagCache.nMisses;
+}
+
+bool VerifyMLSAG(const CTransaction &tx, CValidationState &state, std::vector<CMLSAGCheck> *pvChecks, bool cacheStore)
+{
+    // Script flags do not affect ring signatures, so entries are keyed by wtxid only. Ring members are looked up
+    // by index, which is only reassigned after anon outputs are erased by a disconnect, so the erase count is
+    // part of the entry.
+    uint256 hashCacheEntry;
+    mlsagCache.ComputeEntry(hashCacheEntry, tx.GetWitnessHash(), pblocktree->GetRCTOutputEraseCount());
+    bool fCached = mlsagCache.Get(hashCacheEntry, !cacheStore);
+    if (fCached)
+        mlsagCache.nHits++;
+    else
+        mlsagCache.nMisses++;
+
     int rv;
     std::set<int64_t> setHaveI; // Anon prev-outputs can only be used once per transaction.
     std::set<CCmpPubKey> setHaveKI;
@@ -48,8 +141,12 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
     if (fSplitCommitments)
         vpInputSplitCommits.reserve(tx.vin.size());
 
+    if (pvChecks)
+        pvChecks->reserve(pvChecks->size() + tx.vin.size());
+
     uint256 hashOutputs = tx.GetOutputsHash();
-    for (const auto &txin : tx.vin) {
+    for (unsigned int nIn = 0; nIn < tx.vin.size(); ++nIn) {
+        const CTxIn &txin = tx.vin[nIn];
         if (!txin.IsAnonInput())
             return state.DoS(100, false, REJECT_MALFORMED, "bad-anon-input");
 
@@ -83,7 +180,31 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
         if (vDL.size() != (1 + (nInputs+1) * nRingSize) * 32 + (fSplitCommitments ? 33 : 0))
             return state.DoS(100, false, REJECT_MALFORMED, "bad-anonin-sig-size");
 
-        std::vector<uint8_t> vM(nCols * nRows * 33);
+        // checking for duplicate key image to prevent double spends
+        uint256 txhashKI;
+        for (size_t k = 0; k < nInputs; ++k) {
+            const CCmpPubKey &ki = *((CCmpPubKey*)&vKeyImages[k*33]);
+
+            if (!setHaveKI.insert(ki).second) {
+                return state.DoS(100, false, REJECT_INVALID, "bad-anonin-dup-ki");
+            }
+
+            if (mempool.HaveKeyImage(ki, txhashKI) && txhashKI != txhash) {
+                return state.DoS(100, false, REJECT_INVALID, "bad-anonin-dup-ki");
+            }
+
+            if (pblocktree->ReadRCTKeyImage(ki, txhashKI) && txhashKI != txhash) {
+                return state.DoS(100, false, REJECT_INVALID, "bad-anonin-dup-ki");
+            }
+        }
+
+        // Key images depend on chain state and are always checked, the ring signature itself only depends on the tx
+        if (fCached)
+            continue;
+
+        CMLSAGCheck check(tx, nIn, hashOutputs, nCols, nRows);
+        std::vector<uint8_t> &vM = check.GetMatrix();
+        vM.resize(nCols * nRows * 33);
 
         std::vector<secp256k1_pedersen_commitment> vCommitments;
         vCommitments.reserve(nCols * nInputs);
@@ -126,35 +247,21 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
             }
         }
 
-        // checking for duplicate key image to prevent double spends
-        uint256 txhashKI;
-        for (size_t k = 0; k < nInputs; ++k) {
-            const CCmpPubKey &ki = *((CCmpPubKey*)&vKeyImages[k*33]);
-
-            if (!setHaveKI.insert(ki).second) {
-                return state.DoS(100, false, REJECT_INVALID, "bad-anonin-dup-ki");
-            }
-
-            if (mempool.HaveKeyImage(ki, txhashKI) && txhashKI != txhash) {
-                return state.DoS(100, false, REJECT_INVALID, "bad-anonin-dup-ki");
-            }
-
-            if (pblocktree->ReadRCTKeyImage(ki, txhashKI) && txhashKI != txhash) {
-                return state.DoS(100, false, REJECT_INVALID, "bad-anonin-dup-ki");
-            }
-        }
-
         if (0 != (rv = secp256k1_prepare_mlsag(&vM[0], nullptr, vpOutCommits.size(), vpOutCommits.size(), nCols, nRows,
                 &vpInCommits[0], &vpOutCommits[0], nullptr)))
             return state.DoS(100, error("%s: prepare-mlsag-failed %d", __func__, rv), REJECT_INVALID, "prepare-mlsag-failed");
 
-        if (0 != (rv = secp256k1_verify_mlsag(secp256k1_ctx_blind, hashOutputs.begin(), nCols, nRows, &vM[0], &vKeyImages[0],
-                &vDL[0], &vDL[32])))
-            return state.DoS(100, error("%s: verify-mlsag-failed %d", __func__, rv), REJECT_INVALID, "verify-mlsag-failed");
+        // The signature check is the expensive part, defer it to the check queue if we were given one
+        if (pvChecks) {
+            pvChecks->push_back(CMLSAGCheck());
+            check.swap(pvChecks->back());
+        } else if (!check()) {
+            return state.DoS(100, error("%s: verify-mlsag-failed %d", __func__, check.GetError()), REJECT_INVALID, "verify-mlsag-failed");
+        }
     }
 
     // Verify commitment sums match
-    if (fSplitCommitments) {
+    if (fSplitCommitments && !fCached) {
         std::vector<const uint8_t*> vpOutCommits;
         vpOutCommits.push_back(plainCommitment.data);
 
@@ -171,6 +278,10 @@ bool VerifyMLSAG(const CTransaction &tx, CValidationState &state)
             return state.DoS(100, error("%s: verify-commit-tally-failed %d", __func__, rv), REJECT_INVALID, "verify-commit-tally-failed");
     }
 
+    // Deferred signature checks have not run yet, only remember results that were verified here
+    if (!fCached && cacheStore && !pvChecks)
+        mlsagCache.Set(hashCacheEntry);
+
     return true;
 }
 
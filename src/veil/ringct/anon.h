@@ -6,6 +6,9 @@
 
 #include <inttypes.h>
 #include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <vector>
 
 class CTxMemPool;
 class CValidationState;
@@ -17,8 +20,59 @@ const size_t MAX_ANON_INPUTS = 32; // To raise see MLSAG_MAX_ROWS also
 
 const size_t ANON_FEE_MULTIPLIER = 2;
 
+/** Default for -maxmlsagcachesize, size of the valid MLSAG cache in MiB */
+static const unsigned int DEFAULT_MAX_MLSAG_CACHE_SIZE = 4;
+
+
+/**
+ * Closure representing the verification of a single anon input's MLSAG ring signature.
+ * The ring matrix is gathered and prepared under cs_main, only the signature check is deferred.
+ */
+class CMLSAGCheck
+{
+private:
+    const CTransaction *ptxTo;
+    unsigned int nIn;
+    uint256 hashOutputs;
+    size_t nCols;
+    size_t nRows;
+    std::vector<uint8_t> vM;
+    int error;
+
+public:
+    CMLSAGCheck(): ptxTo(nullptr), nIn(0), nCols(0), nRows(0), error(0) {}
+    CMLSAGCheck(const CTransaction& txToIn, unsigned int nInIn, const uint256& hashOutputsIn, size_t nColsIn, size_t nRowsIn) :
+        ptxTo(&txToIn), nIn(nInIn), hashOutputs(hashOutputsIn), nCols(nColsIn), nRows(nRowsIn), error(0) {}
+
+    bool operator()();
+
+    void swap(CMLSAGCheck &check) {
+        std::swap(ptxTo, check.ptxTo);
+        std::swap(nIn, check.nIn);
+        std::swap(hashOutputs, check.hashOutputs);
+        std::swap(nCols, check.nCols);
+        std::swap(nRows, check.nRows);
+        std::swap(vM, check.vM);
+        std::swap(error, check.error);
+    }
+
+    std::vector<uint8_t>& GetMatrix() { return vM; }
+    int GetError() const { return error; }
+};
+
+/**
+ * Verify the ring signatures and commitment sums of an anon transaction.
+ * If pvChecks is not nullptr, the MLSAG signature checks are pushed onto it instead of being performed inline.
+ * Transactions verified inline with cacheStore set are remembered by wtxid, later calls only check
+ * their key images. Setting cacheStore to false removes matched entries from the cache.
+ */
+bool VerifyMLSAG(const CTransaction &tx, CValidationState &state, std::vector<CMLSAGCheck> *pvChecks = nullptr,
+        bool cacheStore = true);
 
-bool VerifyMLSAG(const CTransaction &tx, CValidationState &state);
+/** Initializes the valid MLSAG cache */
+void InitMLSAGCache();
+/** Get the number of MLSAG cache hits and misses since startup */
+void GetMLSAGCacheStats(uint64_t &nHits, uint64_t &nMisses);
 
 bool AddKeyImagesToMempool(const CTransaction &tx, CTxMemPool &pool);
 bool RemoveKeyImagesFromMempool(const uint256 &hash, const CTxIn &txin, CTxMemPool &pool);
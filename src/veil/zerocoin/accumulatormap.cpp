@@ -4,6 +4,7 @@
 
 #include "accumulatormap.h"
 #include "accumulators.h"
+#include "checkqueue.h"
 #include "txdb.h"
 #include "libzerocoin/Denominations.h"
 #include "validation.h"
@@ -11,6 +12,21 @@
 using namespace libzerocoin;
 using namespace std;
 
+int nAccumulatorThreads = 0;
+
+static CCheckQueue<CAccumulateCheck> accumulatorcheckqueue(1);
+
+void ThreadAccumulatorCheck() {
+    RenameThread("veil-accumulator");
+    accumulatorcheckqueue.Thread();
+}
+
+bool CAccumulateCheck::operator()()
+{
+    pAccumulator->incrementBatch(vPubcoins);
+    return true;
+}
+
 //Construct accumulators for all denominations
 AccumulatorMap::AccumulatorMap(libzerocoin::ZerocoinParams* params)
 {
@@ -75,6 +91,34 @@ bool AccumulatorMap::Accumulate(const PublicCoin& pubCoin, bool fSkipValidation)
     return mapAccumulators.at(denom)->accumulate(pubCoin);
 }
 
+//Add lists of pubcoins to the accumulators of their denominations. The accumulators are independent of each other, so
+//each denomination is done as a separate job on the accumulator threads.
+bool AccumulatorMap::Accumulate(const std::map<libzerocoin::CoinDenomination, std::vector<CBigNum> >& mapPubcoins)
+{
+    std::vector<CAccumulateCheck> vChecks;
+    for (auto& denomPair : mapPubcoins) {
+        if (!mapAccumulators.count(denomPair.first))
+            return false;
+        if (denomPair.second.empty())
+            continue;
+
+        setUnusedDenominations.erase(denomPair.first);
+        vChecks.emplace_back(CAccumulateCheck(mapAccumulators.at(denomPair.first).get(), denomPair.second));
+    }
+
+    CCheckQueueControl<CAccumulateCheck> control(nAccumulatorThreads ? &accumulatorcheckqueue : nullptr);
+    if (nAccumulatorThreads) {
+        control.Add(vChecks);
+        return control.Wait();
+    }
+
+    for (auto& check : vChecks) {
+        if (!check())
+            return false;
+    }
+    return true;
+}
+
 //Get the value of a specific accumulator
 CBigNum AccumulatorMap::GetValue(CoinDenomination denom)
 {
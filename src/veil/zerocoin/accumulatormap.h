@@ -9,6 +9,37 @@
 #include "libzerocoin/Coin.h"
 #include "arith_uint256.h"
 
+/** Maximum number of accumulator threads, there is nothing to gain beyond one per denomination */
+static const int MAX_ACCUMULATOR_THREADS = 4;
+/** -accumulatorthreads default (number of accumulator threads, 0 = auto) */
+static const int DEFAULT_ACCUMULATOR_THREADS = 0;
+
+extern int nAccumulatorThreads;
+
+//Adds a list of pubcoins to the accumulator of a single denomination, run on the accumulator check queue
+class CAccumulateCheck
+{
+private:
+    libzerocoin::Accumulator* pAccumulator;
+    std::vector<CBigNum> vPubcoins;
+
+public:
+    CAccumulateCheck(): pAccumulator(nullptr) {}
+    CAccumulateCheck(libzerocoin::Accumulator* pAccumulatorIn, const std::vector<CBigNum>& vPubcoinsIn) :
+        pAccumulator(pAccumulatorIn), vPubcoins(vPubcoinsIn) {}
+
+    bool operator()();
+
+    void swap(CAccumulateCheck& check)
+    {
+        std::swap(pAccumulator, check.pAccumulator);
+        vPubcoins.swap(check.vPubcoins);
+    }
+};
+
+/** Run an instance of the accumulator checking thread */
+void ThreadAccumulatorCheck();
+
 //A map with an accumulator for each denomination
 class AccumulatorMap
 {
@@ -20,6 +51,7 @@ public:
     explicit AccumulatorMap(libzerocoin::ZerocoinParams* params);
     bool Load(const std::map<libzerocoin::CoinDenomination, uint256>& mapCheckpoints);
     bool Accumulate(const libzerocoin::PublicCoin& pubCoin, bool fSkipValidation = false);
+    bool Accumulate(const std::map<libzerocoin::CoinDenomination, std::vector<CBigNum> >& mapPubcoins);
     CBigNum GetValue(libzerocoin::CoinDenomination denom);
     std::map<libzerocoin::CoinDenomination, uint256> GetCheckpoints(bool fShowZeroIfEmpty = false);
     void Reset();
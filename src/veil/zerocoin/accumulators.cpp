@@ -25,30 +25,50 @@ uint256 GetChecksum(const CBigNum &bnValue)
     return  Hash(ss.begin(), ss.end());
 }
 
-// Find the first occurrence of a certain accumulator checksum. Return 0 if not found.
-int GetChecksumHeight(uint256 hashChecksum, CoinDenomination denomination)
+// First height of each accumulator checksum in the active chain, only counting the heights where checkpoints can change
+static std::map<std::pair<CoinDenomination, uint256>, int> mapChecksumHeights;
+static CCriticalSection cs_checksumheights;
+
+void AddChecksumHeights(const CBlockIndex* pindex)
 {
-    CBlockIndex* pindex = chainActive[0];
-    if (!pindex)
-        return 0;
+    //Checkpoints only change every 10 blocks
+    if (pindex->nHeight % 10 != 0)
+        return;
 
-    //Search through blocks to find the checksum
-    while (pindex) {
-        if (pindex->GetAccumulatorHash(denomination) == hashChecksum)
-            return pindex->nHeight;
-
-        //Skip forward in groups of 10 blocks since checkpoints only change every 10 blocks
-        if (pindex->nHeight % 10 == 0) {
-            if (pindex->nHeight + 10 > chainActive.Height())
-                return 0;
-            pindex = chainActive[pindex->nHeight + 10];
-            continue;
-        }
+    LOCK(cs_checksumheights);
+    for (CoinDenomination denom : zerocoinDenomList)
+        mapChecksumHeights.emplace(std::make_pair(denom, pindex->GetAccumulatorHash(denom)), pindex->nHeight);
+}
 
-        pindex = chainActive.Next(pindex);
+void RemoveChecksumHeights(const CBlockIndex* pindex)
+{
+    if (pindex->nHeight % 10 != 0)
+        return;
+
+    LOCK(cs_checksumheights);
+    for (CoinDenomination denom : zerocoinDenomList) {
+        auto it = mapChecksumHeights.find(std::make_pair(denom, pindex->GetAccumulatorHash(denom)));
+        if (it != mapChecksumHeights.end() && it->second == pindex->nHeight)
+            mapChecksumHeights.erase(it);
     }
+}
 
-    return 0;
+void LoadChecksumHeights(const CChain& chain)
+{
+    LOCK(cs_checksumheights);
+    mapChecksumHeights.clear();
+    for (int nHeight = 0; nHeight <= chain.Height(); nHeight += 10)
+        AddChecksumHeights(chain[nHeight]);
+}
+
+// Find the first occurrence of a certain accumulator checksum. Return 0 if not found.
+int GetChecksumHeight(uint256 hashChecksum, CoinDenomination denomination)
+{
+    LOCK(cs_checksumheights);
+    auto it = mapChecksumHeights.find(std::make_pair(denomination, hashChecksum));
+    if (it == mapChecksumHeights.end())
+        return 0;
+    return it->second;
 }
 
 bool GetAccumulatorValueFromChecksum(const uint256& hashChecksum, bool fMemoryOnly, CBigNum& bnAccValue)
@@ -133,7 +153,7 @@ bool EraseCheckpoints(int nStartHeight, int nEndHeight)
 
     CBlockIndex* pindex = chainActive[nStartHeight];
 
-    auto mapCheckpointsPrev = pindex->pprev->mapAccumulatorHashes;
+    auto mapCheckpointsPrev = pindex->pprev->GetAccumulatorHashes().ToMap();
     while (pindex) {
         //Do not erase the hash if it is the same as the previous block
         for (auto pairPrevious : mapCheckpointsPrev) {
@@ -153,6 +173,31 @@ bool EraseCheckpoints(int nStartHeight, int nEndHeight)
     return true;
 }
 
+//Get the pubcoins minted in a block. Uses the pubcoin index, falling back to reading the block from disk (and
+//indexing it) if the index is missing the block or holds an entry for a block that has since been reorganized away.
+bool GetBlockPubcoins(const CBlockIndex* pindex, CBlockPubcoins& pubcoins)
+{
+    if (pzerocoinDB->ReadBlockPubcoins(pindex->nHeight, pubcoins) && pubcoins.hashBlock == pindex->GetBlockHash())
+        return true;
+
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
+        return error("%s: failed to read block from disk", __func__);
+
+    std::list<PublicCoin> listPubcoins;
+    if (!BlockToPubcoinList(block, listPubcoins))
+        return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
+
+    pubcoins = CBlockPubcoins(pindex->GetBlockHash());
+    for (const PublicCoin& pubcoin : listPubcoins)
+        pubcoins.Add(pubcoin.getDenomination(), pubcoin.getValue());
+
+    if (!pzerocoinDB->WriteBlockPubcoins(pindex->nHeight, pubcoins))
+        LogPrintf("%s: failed to write pubcoin index for block %d\n", __func__, pindex->nHeight);
+
+    return true;
+}
+
 bool InitializeAccumulators(const int nHeight, int& nHeightCheckpoint, AccumulatorMap& mapAccumulators)
 {
     if (nHeight < 20)
@@ -162,7 +207,7 @@ bool InitializeAccumulators(const int nHeight, int& nHeightCheckpoint, Accumulat
     mapAccumulators.Reset(Params().Zerocoin_Params());
 
     //Use the previous block's checkpoint to initialize the accumulator's state
-    auto mapCheckpointPrev = chainActive[nHeight - 1]->mapAccumulatorHashes;
+    auto mapCheckpointPrev = chainActive[nHeight - 1]->GetAccumulatorHashes().ToMap();
     bool fLoad = false;
     for (auto accPair: mapCheckpointPrev) {
         if (accPair.second != uint256()) {
@@ -187,7 +232,7 @@ bool CalculateAccumulatorCheckpoint(int nHeight, std::map<libzerocoin::CoinDenom
 
     //the checkpoint is updated every ten blocks, return current active checkpoint if not update block
     if (nHeight % 10 != 0 || nHeight == 10) {
-        mapCheckpoints = chainActive[nHeight - 1]->mapAccumulatorHashes;
+        mapCheckpoints = chainActive[nHeight - 1]->GetAccumulatorHashes().ToMap();
         return true;
     }
 
@@ -204,34 +249,33 @@ bool CalculateAccumulatorCheckpoint(int nHeight, std::map<libzerocoin::CoinDenom
     if (!pindex)
         return false;
 
+    std::map<CoinDenomination, std::vector<CBigNum> > mapPubcoins;
     while (pindex->nHeight < nHeight - 10) {
         // checking whether we should stop this process due to a shutdown request
         if (ShutdownRequested())
             return false;
 
         //grab mints from this block
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-            return error("%s: failed to read block from disk", __func__);
-
-        std::list<PublicCoin> listPubcoins;
-        if (!BlockToPubcoinList(block, listPubcoins))
+        CBlockPubcoins pubcoins;
+        if (!GetBlockPubcoins(pindex, pubcoins))
             return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
 
-        nTotalMintsFound += listPubcoins.size();
-
-        //add the pubcoins to accumulator
-        for (const PublicCoin& pubcoin : listPubcoins) {
-            if(!mapAccumulators.Accumulate(pubcoin, true))
-                return error("%s: failed to add pubcoin to accumulator at height %d", __func__, pindex->nHeight);
+        for (const auto& denomPair : pubcoins.mapPubcoins) {
+            auto& vPubcoins = mapPubcoins[denomPair.first];
+            vPubcoins.insert(vPubcoins.end(), denomPair.second.begin(), denomPair.second.end());
+            nTotalMintsFound += denomPair.second.size();
         }
 
         pindex = chainActive.Next(pindex);
     }
 
+    //add the pubcoins to accumulator
+    if (!mapAccumulators.Accumulate(mapPubcoins))
+        return error("%s: failed to add pubcoins to accumulator at height %d", __func__, nHeight);
+
     // if there were no new mints found, the accumulator checkpoint will be the same as the last checkpoint
     if (nTotalMintsFound == 0) {
-        mapCheckpoints = chainActive[nHeight - 1]->mapAccumulatorHashes;
+        mapCheckpoints = chainActive[nHeight - 1]->GetAccumulatorHashes().ToMap();
     }
     else
         mapCheckpoints = mapAccumulators.GetCheckpoints();
@@ -251,6 +295,11 @@ std::string PrintAccumulatorCheckpoints(std::map<libzerocoin::CoinDenomination ,
 
 bool ValidateAccumulatorCheckpoint(const CBlock& block, CBlockIndex* pindex, AccumulatorMap& mapAccumulators)
 {
+    // The block index keeps one checkpoint per denomination and nothing else, so any other set of keys could not be
+    // compared exactly against the checkpoints of the next block
+    if (!CDenominationArray<uint256>::IsCanonical(block.mapAccumulatorHashes))
+        return error("%s : accumulator checkpoints do not match the zerocoin denominations", __func__);
+
     if (pindex->nHeight % 10 == 0 && pindex->nHeight > 10) {
         std::map<libzerocoin::CoinDenomination, uint256> mapCheckpointCalculated;
 
@@ -259,13 +308,13 @@ bool ValidateAccumulatorCheckpoint(const CBlock& block, CBlockIndex* pindex, Acc
 
         for (auto checkpointPair: mapAccumulators.GetCheckpoints(true)) {
             if (checkpointPair.second != block.mapAccumulatorHashes.at(checkpointPair.first))
-                return error("%s : accumulator does not match calculated value. block=%s calculated=%s", __func__, pindex->mapAccumulatorHashes.at(checkpointPair.first).GetHex(), checkpointPair.second.GetHex());
+                return error("%s : accumulator does not match calculated value. block=%s calculated=%s", __func__, pindex->GetAccumulatorHash(checkpointPair.first).GetHex(), checkpointPair.second.GetHex());
         }
 
         return true;
     }
 
-    if (block.mapAccumulatorHashes != pindex->pprev->mapAccumulatorHashes)
+    if (block.mapAccumulatorHashes != pindex->pprev->GetAccumulatorHashes().ToMap())
         return error("%s : new accumulator checkpoint generated on a block that is not multiple of 10", __func__);
 
     return true;
@@ -293,15 +342,16 @@ int ComputeAccumulatedCoins(int nHeightEnd, libzerocoin::CoinDenomination denom)
     CBlockIndex* pindex = chainActive[GetZerocoinStartHeight()];
     int n = 0;
     while (pindex->nHeight < nHeightEnd) {
-        n += count(pindex->vMintDenominationsInBlock.begin(), pindex->vMintDenominationsInBlock.end(), denom);
+        n += pindex->GetMintCount(denom);
         pindex = chainActive.Next(pindex);
     }
 
     return n;
 }
 
-int AddBlockMintsToAccumulator(const libzerocoin::PublicCoin& coin, const int nHeightMintAdded, const CBlockIndex* pindex,
-                           libzerocoin::Accumulator* accumulator, bool isWitness)
+//Add the mints of the coin's denomination in this block to the list of values that are to be accumulated
+int AddBlockMintsToList(const libzerocoin::PublicCoin& coin, const int nHeightMintAdded, const CBlockIndex* pindex,
+                        std::vector<CBigNum>& vPubcoins, bool isWitness)
 {
     // if this block contains mints of the denomination that is being spent, then add them to the witness
     if (!pindex->MintedDenomination(coin.getDenomination()))
@@ -309,28 +359,23 @@ int AddBlockMintsToAccumulator(const libzerocoin::PublicCoin& coin, const int nH
 
     int nMintsAdded = 0;
     int nHeight = pindex->nHeight;
-    list<PublicCoin> listPubcoins;
-    //Do not keep cs_main locked during modular exponentiation (unless this is already locked from the validation)
+    CBlockPubcoins pubcoins;
     {
         LOCK(cs_main);
         //grab mints from this block
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus()))
-            return error("%s: failed to read block from disk while adding pubcoins to witness", __func__);
-
-        if (!BlockToPubcoinList(block, listPubcoins))
-            return error("%s: failed to get zerocoin mintlist from block %n\n", __func__, pindex->nHeight);
+        if (!GetBlockPubcoins(pindex, pubcoins))
+            return error("%s: failed to get zerocoin mintlist from block %d\n", __func__, pindex->nHeight);
     }
 
-    //add the mints to the witness
-    for (const PublicCoin& pubcoin : listPubcoins) {
-        if (pubcoin.getDenomination() != coin.getDenomination())
-            continue;
+    auto it = pubcoins.mapPubcoins.find(coin.getDenomination());
+    if (it == pubcoins.mapPubcoins.end())
+        return 0;
 
-        if (isWitness && nHeight == nHeightMintAdded && pubcoin.getValue() == coin.getValue())
+    for (const CBigNum& bnValue : it->second) {
+        if (isWitness && nHeight == nHeightMintAdded && bnValue == coin.getValue())
             continue;
 
-        accumulator->increment(pubcoin.getValue());
+        vPubcoins.emplace_back(bnValue);
         ++nMintsAdded;
     }
 
@@ -348,31 +393,44 @@ bool GetAccumulatorValue(int& nHeight, const libzerocoin::CoinDenomination denom
 }
 
 bool GenerateAccumulatorWitness(const PublicCoin &coin, Accumulator& accumulator, AccumulatorWitness& witness,
-        int nSecurityLevel, int& nMintsAdded, string& strError, CBlockIndex* pindexCheckpoint)
+        int nSecurityLevel, int& nMintsAdded, string& strError, CBlockIndex* pindexCheckpoint, CCoinWitnessData* pwitnessData)
 {
     LogPrintf("%s: generating\n", __func__);
     CBlockIndex* pindex = nullptr;
+    CBlockIndex* pindexStop = nullptr;
     CBigNum bnAccValue = 0;
     int nAccStartHeight = 0;
     int nHeightStop = 0;
     int nHeightMintAdded = 0;
+    int nHeightResume = 0;
     {
         LOCK(cs_main);
 
-        uint256 txid;
-        if (!pzerocoinDB->ReadCoinMint(coin.getValue(), txid))
-            return error("%s failed to find mint %s in blockchain db", __func__, GetPubCoinHash(coin.getValue()).GetHex());
-
-        CTransactionRef txMinted;
-        uint256 hashBlock;
-        if (!GetTransaction(txid, txMinted, Params().GetConsensus(), hashBlock, true))
-            return error("%s failed to read tx %s", __func__, txid.GetHex());
-
-        int nHeightTest;
-        if (!IsBlockHashInChain(hashBlock, nHeightTest))
-            return error("%s: mint tx %s is not in chain", __func__, txid.GetHex());
-
-        nHeightMintAdded = mapBlockIndex[hashBlock]->nHeight;
+        //A cached witness can be resumed as long as the blocks it was built from are still in the active chain
+        if (pwitnessData && !pwitnessData->IsNull() && pwitnessData->bnPubcoin == coin.getValue() &&
+                pwitnessData->nHeightNext <= chainActive.Height() + 1 &&
+                chainActive[pwitnessData->nHeightNext - 1]->GetBlockHash() == pwitnessData->hashBlockLast) {
+            nHeightMintAdded = pwitnessData->nHeightMint;
+            nHeightResume = pwitnessData->nHeightNext;
+        } else {
+            if (pwitnessData)
+                *pwitnessData = CCoinWitnessData(coin.getValue(), coin.getDenomination());
+
+            uint256 txid;
+            if (!pzerocoinDB->ReadCoinMint(coin.getValue(), txid))
+                return error("%s failed to find mint %s in blockchain db", __func__, GetPubCoinHash(coin.getValue()).GetHex());
+
+            CTransactionRef txMinted;
+            uint256 hashBlock;
+            if (!GetTransaction(txid, txMinted, Params().GetConsensus(), hashBlock, true))
+                return error("%s failed to read tx %s", __func__, txid.GetHex());
+
+            int nHeightTest;
+            if (!IsBlockHashInChain(hashBlock, nHeightTest))
+                return error("%s: mint tx %s is not in chain", __func__, txid.GetHex());
+
+            nHeightMintAdded = mapBlockIndex[hashBlock]->nHeight;
+        }
 
         //get the checkpoint added at the next multiple of 10
         int nHeightCheckpoint = nHeightMintAdded + (10 - (nHeightMintAdded % 10));
@@ -393,17 +451,17 @@ bool GenerateAccumulatorWitness(const PublicCoin &coin, Accumulator& accumulator
         if (pindexCheckpoint)
             nHeightStop = pindexCheckpoint->nHeight - 10;
     }
-    //Iterate through the chain and calculate the witness
-    int nCheckpointsAdded = 0;
-    nMintsAdded = 0;
-    RandomizeSecurityLevel(nSecurityLevel); //make security level not always the same and predictable
     libzerocoin::Accumulator witnessAccumulator = accumulator;
+    CBlockIndex* pindexStart = pindex;
 
-    while (pindex) {
-        {
-            LOCK(cs_main);
+    //Iterate through the chain to find the checkpoint that the witness is generated for
+    int nCheckpointsAdded = 0;
+    RandomizeSecurityLevel(nSecurityLevel); //make security level not always the same and predictable
+    {
+        LOCK(cs_main);
+        while (pindex) {
             if (pindex->nHeight != nAccStartHeight &&
-                pindex->pprev->mapAccumulatorHashes != pindex->mapAccumulatorHashes)
+                pindex->pprev->GetAccumulatorHashes() != pindex->GetAccumulatorHashes())
                 ++nCheckpointsAdded;
 
             //If the security level is satisfied, or the stop height is reached, then initialize the accumulator from here
@@ -417,18 +475,71 @@ bool GenerateAccumulatorWitness(const PublicCoin &coin, Accumulator& accumulator
                     return error("%s : failed to find checksum in database for accumulator", __func__);
 
                 accumulator.setValue(bnAccValue);
+                pindexStop = pindex;
                 break;
             }
+
+            pindex = chainActive.Next(pindex);
+        }
+    }
+
+    if (!pindexStop)
+        return error("%s: failed to find a checkpoint to generate the witness for", __func__);
+
+    //Pick up from the cached witness if it does not go beyond the stop block. A cached witness that does go beyond it is
+    //still the same value if no mints of this denomination were added in the blocks between.
+    nMintsAdded = 0;
+    pindex = pindexStart;
+    bool fUseCache = false;
+    bool fUpdateCache = pwitnessData != nullptr;
+    if (nHeightResume) {
+        LOCK(cs_main);
+        fUseCache = true;
+        if (nHeightResume <= pindexStop->nHeight) {
+            pindex = chainActive[nHeightResume];
+        } else {
+            for (int nHeight = pindexStop->nHeight; nHeight < nHeightResume; nHeight++) {
+                if (chainActive[nHeight]->MintedDenomination(coin.getDenomination())) {
+                    fUseCache = false;
+                    break;
+                }
+            }
+            pindex = pindexStop;
+            fUpdateCache = false;
         }
 
-        //Do not lock cs_main here so that computation does not leave everything else bound up
-        nMintsAdded += AddBlockMintsToAccumulator(coin, nHeightMintAdded, pindex, &witnessAccumulator, true);
+        if (fUseCache) {
+            witnessAccumulator.setValue(pwitnessData->bnWitness);
+            nMintsAdded = pwitnessData->nMintsAdded;
+        } else {
+            pindex = pindexStart;
+        }
+    }
+
+    std::vector<CBigNum> vPubcoins;
+    while (pindex && pindex != pindexStop) {
+        nMintsAdded += AddBlockMintsToList(coin, nHeightMintAdded, pindex, vPubcoins, true);
         pindex = chainActive.Next(pindex);
     }
 
+    //Do not lock cs_main here so that computation does not leave everything else bound up
+    witnessAccumulator.incrementBatch(vPubcoins);
+
     witness.resetValue(witnessAccumulator, coin);
-    if (!witness.VerifyWitness(accumulator, coin))
+    if (!pindex || !witness.VerifyWitness(accumulator, coin)) {
+        if (pwitnessData && fUseCache)
+            pwitnessData->Reset();
         return error("%s: failed to verify witness", __func__);
+    }
+
+    if (fUpdateCache) {
+        LOCK(cs_main);
+        pwitnessData->nHeightMint = nHeightMintAdded;
+        pwitnessData->nHeightNext = pindexStop->nHeight;
+        pwitnessData->hashBlockLast = pindexStop->pprev->GetBlockHash();
+        pwitnessData->bnWitness = witnessAccumulator.getValue();
+        pwitnessData->nMintsAdded = nMintsAdded;
+    }
 
     // A certain amount of accumulated coins are required
     if (nMintsAdded < Params().Zerocoin_RequiredAccumulation()) {
@@ -460,8 +571,7 @@ map<CoinDenomination, int> GetMintMaturityHeight()
         for (auto denom : libzerocoin::zerocoinDenomList) {
             //If the denom has not already had a mint added to it, then see if it has a mint added on this block
             if (mapDenomMaturity.at(denom).first < Params().Zerocoin_RequiredAccumulation()) {
-                mapDenomMaturity.at(denom).first += count(pindex->vMintDenominationsInBlock.begin(),
-                                                          pindex->vMintDenominationsInBlock.end(), denom);
+                mapDenomMaturity.at(denom).first += pindex->GetMintCount(denom);
 
                 //if mint was found then record this block as the first block that maturity occurs.
                 if (mapDenomMaturity.at(denom).first >= Params().Zerocoin_RequiredAccumulation())
@@ -14,9 +14,11 @@
 #include "arith_uint256.h"
 
 class CBlockIndex;
+class CCoinWitnessData;
 
 std::map<libzerocoin::CoinDenomination, int> GetMintMaturityHeight();
-bool GenerateAccumulatorWitness(const libzerocoin::PublicCoin &coin, libzerocoin::Accumulator& accumulator, libzerocoin::AccumulatorWitness& witness, int nSecurityLevel, int& nMintsAdded, std::string& strError, CBlockIndex* pindexCheckpoint = nullptr);
+bool GenerateAccumulatorWitness(const libzerocoin::PublicCoin &coin, libzerocoin::Accumulator& accumulator, libzerocoin::AccumulatorWitness& witness, int nSecurityLevel, int& nMintsAdded, std::string& strError, CBlockIndex* pindexCheckpoint = nullptr, CCoinWitnessData* pwitnessData = nullptr);
+bool GetBlockPubcoins(const CBlockIndex* pindex, CBlockPubcoins& pubcoins);
 bool GetAccumulatorValueFromDB(uint256 nCheckpoint, libzerocoin::CoinDenomination denom, CBigNum& bnAccValue);
 bool GetAccumulatorValueFromChecksum(const uint256& hashChecksum, bool fMemoryOnly, CBigNum& bnAccValue);
 void AddAccumulatorChecksum(const uint256 nChecksum, const CBigNum &bnValue, bool fMemoryOnly);
@@ -26,6 +28,9 @@ bool LoadAccumulatorValuesFromDB(const uint256 nCheckpoint);
 bool EraseAccumulatorValues(const uint256& nCheckpointErase, const uint256& nCheckpointPrevious);
 uint256 GetChecksum(const CBigNum &bnValue);
 int GetChecksumHeight(uint256 nChecksum, libzerocoin::CoinDenomination denomination);
+void AddChecksumHeights(const CBlockIndex* pindex);
+void RemoveChecksumHeights(const CBlockIndex* pindex);
+void LoadChecksumHeights(const CChain& chain);
 bool ValidateAccumulatorCheckpoint(const CBlock& block, CBlockIndex* pindex, AccumulatorMap& mapAccumulators);
 
 #endif //PIVX_ACCUMULATORS_H
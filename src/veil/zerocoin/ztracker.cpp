@@ -26,6 +26,7 @@ CzTracker::CzTracker(CWallet* wallet)
     mapSerialHashes.clear();
     mapPendingSpends.clear();
     fInitialized = false;
+    fWitnessDataLoaded = false;
 }
 
 CzTracker::~CzTracker()
@@ -499,6 +500,81 @@ std::set<CMintMeta> CzTracker::ListMints(bool fUnusedOnly, bool fMatureOnly, boo
     return setMints;
 }
 
+//Load the cached accumulator witnesses from the database the first time they are needed
+void CzTracker::LoadWitnessData()
+{
+    AssertLockHeld(cs_witness);
+    if (fWitnessDataLoaded)
+        return;
+
+    for (auto& witnessData : WalletBatch(*walletDatabase).ListWitnessData())
+        mapWitnessData[witnessData.GetPubcoinHash()] = witnessData;
+    fWitnessDataLoaded = true;
+}
+
+bool CzTracker::GetWitnessData(const PubCoinHash& hashPubcoin, CCoinWitnessData& witnessData)
+{
+    LOCK(cs_witness);
+    LoadWitnessData();
+    auto it = mapWitnessData.find(hashPubcoin);
+    if (it == mapWitnessData.end())
+        return false;
+
+    witnessData = it->second;
+    return true;
+}
+
+std::vector<CCoinWitnessData> CzTracker::ListWitnessData()
+{
+    LOCK(cs_witness);
+    LoadWitnessData();
+    std::vector<CCoinWitnessData> vWitnessData;
+    for (auto& it : mapWitnessData)
+        vWitnessData.emplace_back(it.second);
+
+    return vWitnessData;
+}
+
+void CzTracker::SetWitnessData(const CCoinWitnessData& witnessData)
+{
+    if (witnessData.IsNull()) {
+        EraseWitnessData(witnessData.GetPubcoinHash());
+        return;
+    }
+
+    LOCK(cs_witness);
+    LoadWitnessData();
+    mapWitnessData[witnessData.GetPubcoinHash()] = witnessData;
+    if (!WalletBatch(*walletDatabase).WriteWitnessData(witnessData))
+        LogPrintf("%s: failed to write witness for pubcoinhash %s\n", __func__, witnessData.GetPubcoinHash().GetHex());
+}
+
+void CzTracker::EraseWitnessData(const PubCoinHash& hashPubcoin)
+{
+    LOCK(cs_witness);
+    LoadWitnessData();
+    if (!mapWitnessData.erase(hashPubcoin))
+        return;
+
+    WalletBatch(*walletDatabase).EraseWitnessData(hashPubcoin);
+}
+
+//Drop cached witnesses that include blocks at or above nHeight, used when those blocks are disconnected
+void CzTracker::RewindWitnessData(int nHeight)
+{
+    LOCK(cs_witness);
+    LoadWitnessData();
+    WalletBatch walletdb(*walletDatabase);
+    for (auto it = mapWitnessData.begin(); it != mapWitnessData.end();) {
+        if (it->second.nHeightNext > nHeight) {
+            walletdb.EraseWitnessData(it->first);
+            it = mapWitnessData.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
 void CzTracker::Clear()
 {
     mapSerialHashes.clear();
@@ -6,6 +6,7 @@
 #define VEIL_ZTRACKER_H
 
 #include "primitives/zerocoin.h"
+#include "sync.h"
 #include "wallet/walletdb.h"
 #include <list>
 
@@ -23,7 +24,11 @@ private:
     std::map<SerialHash, CMintMeta> mapSerialHashes;
     std::map<SerialHash, uint256> mapPendingSpends; //serialhash, txid of spend
     std::map<PubCoinHash, SerialHash> mapHashPubCoin;
+    CCriticalSection cs_witness;
+    bool fWitnessDataLoaded;
+    std::map<PubCoinHash, CCoinWitnessData> mapWitnessData;
     bool UpdateStatusInternal(const std::set<uint256>& setMempool, CMintMeta& mint);
+    void LoadWitnessData();
 public:
     CzTracker(CWallet* wallet);
     ~CzTracker();
@@ -51,6 +56,11 @@ public:
     bool UnArchive(const PubCoinHash& hashPubcoin, bool isDeterministic);
     bool UpdateZerocoinMint(const CZerocoinMint& mint);
     bool UpdateState(const CMintMeta& meta);
+    bool GetWitnessData(const PubCoinHash& hashPubcoin, CCoinWitnessData& witnessData);
+    std::vector<CCoinWitnessData> ListWitnessData();
+    void SetWitnessData(const CCoinWitnessData& witnessData);
+    void EraseWitnessData(const PubCoinHash& hashPubcoin);
+    void RewindWitnessData(int nHeight);
     void Clear();
 };
 
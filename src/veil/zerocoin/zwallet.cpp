@@ -14,6 +14,11 @@
 #include "consensus/validation.h"
 #include "shutdown.h"
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 using namespace libzerocoin;
 
 CzWallet::CzWallet(CWallet* wallet)
@@ -93,6 +98,9 @@ void CzWallet::AddToMintPool(const std::pair<uint256, uint32_t>& pMint, bool fVe
     mintPool.Add(pMint, fVerbose);
 }
 
+/** Number of counts a mint pool worker claims at a time */
+static const size_t MINTPOOL_GENERATE_GROUP = 4;
+
 //Add the next 20 mints to the mint pool
 void CzWallet::GenerateMintPool(uint32_t nCountStart, uint32_t nCountEnd)
 {
@@ -109,42 +117,70 @@ void CzWallet::GenerateMintPool(uint32_t nCountStart, uint32_t nCountEnd)
     if (nCountEnd > 0)
         nStop = std::max(n, n + nCountEnd);
 
-    bool fFound;
-
     if (!mapMasterSeeds.count(seedMasterID)) {
         LogPrintf("%s: do not have master seed with ID %s loaded!", __func__, seedMasterID.GetHex());
         return;
     }
 
     LogPrintf("%s : n=%d nStop=%d\n", __func__, n, nStop - 1);
-    for (uint32_t i = n; i < nStop; ++i) {
-        if (ShutdownRequested())
-            return;
 
-        fFound = false;
+    // Prevent unnecessary repeated minted
+    std::vector<uint32_t> vCounts;
+    for (uint32_t i = n; i < nStop; ++i) {
+        if (!mintPool.HasCount(i))
+            vCounts.emplace_back(i);
+    }
 
-        // Prevent unnecessary repeated minted
-        for (auto& pair : mintPool) {
-            if(pair.second == i) {
-                fFound = true;
-                break;
+    // Every count needs its own modular exponentiations and primality tests, so derive them on all cores. Workers
+    // claim small groups of counts so a count that needs many attempts does not hold up the rest.
+    // The first exception thrown by a worker stops the others and is rethrown here once they are joined.
+    std::vector<CBigNum> vValues(vCounts.size());
+    std::atomic<size_t> nNext(0);
+    std::mutex csError;
+    std::exception_ptr error;
+    auto generate = [&]() {
+        try {
+            while (!ShutdownRequested()) {
+                size_t nBegin = nNext.fetch_add(MINTPOOL_GENERATE_GROUP);
+                if (nBegin >= vCounts.size())
+                    return;
+                size_t nEnd = std::min(nBegin + MINTPOOL_GENERATE_GROUP, vCounts.size());
+                for (size_t j = nBegin; j < nEnd; j++) {
+                    uint512 seedZerocoin = GetZerocoinSeed(seedMasterID, vCounts[j]);
+                    CBigNum bnSerial;
+                    CBigNum bnRandomness;
+                    CKey key;
+                    SeedToZerocoin(seedZerocoin, vValues[j], bnSerial, bnRandomness, key);
+                }
             }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(csError);
+            if (!error)
+                error = std::current_exception();
+            nNext = vCounts.size();
         }
+    };
+
+    size_t nThreads = std::min((size_t)std::max(GetNumCores(), 1), (vCounts.size() + MINTPOOL_GENERATE_GROUP - 1) / MINTPOOL_GENERATE_GROUP);
+    std::vector<std::thread> vThreads;
+    for (size_t t = 1; t < nThreads; t++)
+        vThreads.emplace_back(generate);
+    generate();
+    for (std::thread& thread : vThreads)
+        thread.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    if (ShutdownRequested())
+        return;
 
-        if(fFound)
-            continue;
-
-        uint512 seedZerocoin = GetZerocoinSeed(seedMasterID, i);
-        CBigNum bnValue;
-        CBigNum bnSerial;
-        CBigNum bnRandomness;
-        CKey key;
-        SeedToZerocoin(seedZerocoin, bnValue, bnSerial, bnRandomness, key);
-
-        mintPool.Add(bnValue, i);
-        WalletBatch(*walletDatabase).WriteMintPoolPair(seedMasterID, GetPubCoinHash(bnValue), i);
-        LogPrintf("%s : %s count=%d\n", __func__, bnValue.GetHex().substr(0, 6), i);
+    WalletBatch walletdb(*walletDatabase);
+    walletdb.TxnBegin();
+    for (size_t j = 0; j < vCounts.size(); j++) {
+        mintPool.Add(vValues[j], vCounts[j]);
+        walletdb.WriteMintPoolPair(seedMasterID, GetPubCoinHash(vValues[j]), vCounts[j]);
     }
+    walletdb.TxnCommit();
 }
 
 // pubcoin hashes are stored to db so that a full accounting of mints belonging to the seed can be tracked without regenerating
@@ -1322,25 +1322,30 @@ void CWallet::TransactionRemovedFromMempool(const CTransactionRef &ptx) {
 }
 
 void CWallet::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted) {
-    LOCK2(cs_main, cs_wallet);
-    // TODO: Temporarily ensure that mempool removals are notified before
-    // connected transactions.  This shouldn't matter, but the abandoned
-    // state of transactions in our wallet is currently cleared when we
-    // receive another notification and there is a race condition where
-    // notification of a connected conflict might cause an outside process
-    // to abandon a transaction and then have it inadvertently cleared by
-    // the notification that the conflicted transaction was evicted.
-
-    for (const CTransactionRef& ptx : vtxConflicted) {
-        SyncTransaction(ptx);
-        TransactionRemovedFromMempool(ptx);
-    }
-    for (size_t i = 0; i < pblock->vtx.size(); i++) {
-        SyncTransaction(pblock->vtx[i], pindex, i);
-        TransactionRemovedFromMempool(pblock->vtx[i]);
+    {
+        LOCK2(cs_main, cs_wallet);
+        // TODO: Temporarily ensure that mempool removals are notified before
+        // connected transactions.  This shouldn't matter, but the abandoned
+        // state of transactions in our wallet is currently cleared when we
+        // receive another notification and there is a race condition where
+        // notification of a connected conflict might cause an outside process
+        // to abandon a transaction and then have it inadvertently cleared by
+        // the notification that the conflicted transaction was evicted.
+
+        for (const CTransactionRef& ptx : vtxConflicted) {
+            SyncTransaction(ptx);
+            TransactionRemovedFromMempool(ptx);
+        }
+        for (size_t i = 0; i < pblock->vtx.size(); i++) {
+            SyncTransaction(pblock->vtx[i], pindex, i);
+            TransactionRemovedFromMempool(pblock->vtx[i]);
+        }
+
+        m_last_block_processed = pindex;
     }
 
-    m_last_block_processed = pindex;
+    // Modular exponentiation is slow, so this is done without holding cs_main
+    AdvanceZerocoinWitnesses();
 }
 
 void CWallet::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) {
@@ -1349,6 +1354,61 @@ void CWallet::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) {
     for (const CTransactionRef& ptx : pblock->vtx) {
         SyncTransaction(ptx);
     }
+
+    auto mi = mapBlockIndex.find(pblock->GetHash());
+    if (zTracker && mi != mapBlockIndex.end())
+        zTracker->RewindWitnessData(mi->second->nHeight);
+}
+
+/**
+ * Advance the cached witnesses of our unspent zerocoins up to the checkpoint that a stake would currently use, so that
+ * staking and spending only need to accumulate the mints added since the last block.
+ */
+void CWallet::AdvanceZerocoinWitnesses()
+{
+    if (!zTracker || IsInitialBlockDownload())
+        return;
+
+    std::map<libzerocoin::CoinDenomination, CBlockIndex*> mapCheckpoints;
+    std::vector<CCoinWitnessData> vWitnessData;
+    {
+        LOCK2(cs_main, cs_wallet);
+        int nHeightChecksum = chainActive.Height() + 1 - Params().Zerocoin_RequiredStakeDepth();
+        if (nHeightChecksum <= 0)
+            return;
+
+        for (auto denom : libzerocoin::zerocoinDenomList) {
+            uint256 hashChecksum = chainActive[nHeightChecksum]->GetAccumulatorHash(denom);
+            mapCheckpoints[denom] = chainActive[GetChecksumHeight(hashChecksum, denom)];
+        }
+
+        for (const CCoinWitnessData& witnessData : zTracker->ListWitnessData()) {
+            CMintMeta meta = zTracker->GetMetaFromPubcoin(witnessData.GetPubcoinHash());
+            if (meta.hashPubcoin.IsNull() || meta.isUsed || meta.isArchived) {
+                zTracker->EraseWitnessData(witnessData.GetPubcoinHash());
+                continue;
+            }
+
+            CBlockIndex* pindexCheckpoint = mapCheckpoints.at(witnessData.denom);
+            if (!pindexCheckpoint || witnessData.nHeightNext >= pindexCheckpoint->nHeight - 10)
+                continue;
+            vWitnessData.emplace_back(witnessData);
+        }
+    }
+
+    for (CCoinWitnessData& witnessData : vWitnessData) {
+        if (ShutdownRequested())
+            return;
+
+        libzerocoin::PublicCoin pubcoin(Params().Zerocoin_Params(), witnessData.bnPubcoin, witnessData.denom);
+        libzerocoin::Accumulator accumulator(Params().Zerocoin_Params(), witnessData.denom);
+        libzerocoin::AccumulatorWitness witness(Params().Zerocoin_Params(), accumulator, pubcoin);
+        std::string strError;
+        int nMintsAdded = 0;
+        GenerateAccumulatorWitness(pubcoin, accumulator, witness, 100, nMintsAdded, strError,
+                mapCheckpoints.at(witnessData.denom), &witnessData);
+        zTracker->SetWitnessData(witnessData);
+    }
 }
 
 
@@ -3566,14 +3626,11 @@ bool CWallet::CreateCoinStake(unsigned int nBits, CMutableTransaction& txNew, un
     if (GetAdjustedTime() - chainActive.Tip()->GetBlockTime() < 60)
         MilliSleep(10000);
 
-    CAmount nCredit = 0;
-    CScript scriptPubKeyKernel;
-    bool fKernelFound = false;
+    // Prepare the kernel hash state of every input once, then search them all together
+    unsigned int nTimeTx = GetAdjustedTime();
+    std::vector<CStakeInput*> vKernelInputs;
+    std::vector<CStakeKernel> vKernels;
     for (std::unique_ptr<CStakeInput>& stakeInput : listInputs) {
-        // Make sure the wallet is unlocked and shutdown hasn't been requested
-        if (IsLocked() || ShutdownRequested())
-            return false;
-
         //make sure that enough time has elapsed between
         CBlockIndex *pindex = stakeInput->GetIndexFrom();
         if (!pindex || pindex->nHeight < 1) {
@@ -3581,78 +3638,96 @@ bool CWallet::CreateCoinStake(unsigned int nBits, CMutableTransaction& txNew, un
             continue;
         }
 
-        // Read block header
-        CBlockHeader block = pindex->GetBlockHeader();
-        uint256 hashProofOfStake;
-        nTxNewTime = GetAdjustedTime();
+        CStakeKernel kernel;
+        if (!GetStakeKernel(stakeInput.get(), nBits, nTimeTx, kernel))
+            continue;
+        vKernelInputs.emplace_back(stakeInput.get());
+        vKernels.emplace_back(kernel);
+    }
 
-        //iterates each utxo inside of CheckStakeKernelHash()
-        if (Stake(stakeInput.get(), nBits, block.GetBlockTime(), nTxNewTime, hashProofOfStake)) {
-            int nHeight = 0;
-            {
-                LOCK(cs_main);
-                //Double check that this will pass time requirements
-                if (nTxNewTime <= chainActive.Tip()->GetMedianTimePast()) {
-                    LogPrintf("CreateCoinStake() : kernel found, but it is too far in the past \n");
-                    continue;
-                }
-                nHeight = chainActive.Height();
-            }
+    CAmount nCredit = 0;
+    CScript scriptPubKeyKernel;
+    bool fKernelFound = false;
+    size_t nKernel = 0;
+    while (nKernel < vKernels.size()) {
+        // Make sure the wallet is unlocked and shutdown hasn't been requested
+        if (IsLocked() || ShutdownRequested())
+            return false;
 
-            // Found a kernel
-            LogPrintf("CreateCoinStake : kernel found\n");
-            nCredit += stakeInput->GetValue();
-
-            // Calculate reward
-            CAmount nBlockReward, nFounderPayment, nLabPayment, nBudgetPayment;
-            veil::Budget().GetBlockRewards(nHeight, nBlockReward, nFounderPayment, nLabPayment, nBudgetPayment);
-            nCredit += nBlockReward;
-            CBlockIndex* pindexPrev = chainActive.Tip();
-            assert(pindexPrev != nullptr);
-            CAmount nNetworkRewardReserve = pindexPrev ? pindexPrev->nNetworkRewardReserve : 0;
-            CAmount nNetworkReward = nNetworkRewardReserve > Params().MaxNetworkReward() ? Params().MaxNetworkReward() : nNetworkRewardReserve;
-            nCredit += nNetworkReward;
-
-            // Create the output transaction(s)
-            vector<CTxOut> vout;
-            if (!stakeInput->CreateTxOuts(this, vout, nBlockReward)) {
-                LogPrintf("%s : failed to get scriptPubKey\n", __func__);
+        uint256 hashProofOfStake;
+        nKernel = FindStakeKernel(vKernels, nKernel, nTimeTx, nTxNewTime, hashProofOfStake);
+        if (nKernel == vKernels.size())
+            break;
+        CStakeInput* stakeInput = vKernelInputs[nKernel++];
+
+        int nHeight = 0;
+        {
+            LOCK(cs_main);
+            //Double check that this will pass time requirements
+            if (nTxNewTime <= chainActive.Tip()->GetMedianTimePast()) {
+                LogPrintf("CreateCoinStake() : kernel found, but it is too far in the past \n");
                 continue;
             }
-            txNew.vpout.clear();
-            txNew.vpout.emplace_back(CTxOut(0, scriptEmpty).GetSharedPtr());
-            for (auto& txOut : vout)
-                txNew.vpout.emplace_back(txOut.GetSharedPtr());
+            nHeight = chainActive.Height();
+        }
+
+        // Found a kernel
+        LogPrintf("CreateCoinStake : kernel found\n");
+        nCredit += stakeInput->GetValue();
+
+        // Calculate reward
+        CAmount nBlockReward, nFounderPayment, nLabPayment, nBudgetPayment;
+        veil::Budget().GetBlockRewards(nHeight, nBlockReward, nFounderPayment, nLabPayment, nBudgetPayment);
+        nCredit += nBlockReward;
+        CBlockIndex* pindexPrev = chainActive.Tip();
+        assert(pindexPrev != nullptr);
+        CAmount nNetworkRewardReserve = pindexPrev ? pindexPrev->nNetworkRewardReserve : 0;
+        CAmount nNetworkReward = nNetworkRewardReserve > Params().MaxNetworkReward() ? Params().MaxNetworkReward() : nNetworkRewardReserve;
+        nCredit += nNetworkReward;
+
+        // Create the output transaction(s)
+        vector<CTxOut> vout;
+        if (!stakeInput->CreateTxOuts(this, vout, nBlockReward)) {
+            LogPrintf("%s : failed to get scriptPubKey\n", __func__);
+            continue;
+        }
+        txNew.vpout.clear();
+        txNew.vpout.emplace_back(CTxOut(0, scriptEmpty).GetSharedPtr());
+        for (auto& txOut : vout)
+            txNew.vpout.emplace_back(txOut.GetSharedPtr());
 
-            // Limit size
-            unsigned int nBytes = ::GetSerializeSize(txNew, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS) * WITNESS_SCALE_FACTOR;
+        // Limit size
+        unsigned int nBytes = ::GetSerializeSize(txNew, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS) * WITNESS_SCALE_FACTOR;
 
-            if (nBytes >= MAX_BLOCK_WEIGHT / 5)
-                return error("CreateCoinStake : exceeded coinstake size limit");
+        if (nBytes >= MAX_BLOCK_WEIGHT / 5)
+            return error("CreateCoinStake : exceeded coinstake size limit");
 
-            uint256 hashTxOut = txNew.GetOutputsHash();
-            CTxIn in;
-            {
-                if (!stakeInput->CreateTxIn(this, in, hashTxOut)) {
-                    LogPrintf("%s : failed to create TxIn\n", __func__);
-                    txNew.vin.clear();
-                    txNew.vpout.clear();
-                    nCredit = 0;
-                    continue;
-                }
+        uint256 hashTxOut = txNew.GetOutputsHash();
+        CTxIn in;
+        {
+            if (!stakeInput->CreateTxIn(this, in, hashTxOut)) {
+                LogPrintf("%s : failed to create TxIn\n", __func__);
+                txNew.vin.clear();
+                txNew.vpout.clear();
+                nCredit = 0;
+                continue;
             }
-            txNew.vin.emplace_back(in);
+        }
+        txNew.vin.emplace_back(in);
 
-            //Mark mints as spent
-            auto* z = (ZerocoinStake*)stakeInput.get();
-            if (!z->MarkSpent(this, txNew.GetHash()))
-                return error("%s: failed to mark mint as used\n", __func__);
+        //Mark mints as spent
+        auto* z = (ZerocoinStake*)stakeInput;
+        if (!z->MarkSpent(this, txNew.GetHash()))
+            return error("%s: failed to mark mint as used\n", __func__);
 
-            fKernelFound = true;
-            break;
-        }
-        if (fKernelFound)
-            break; // if kernel is found stop searching
+        fKernelFound = true;
+        break;
+    }
+
+    {
+        LOCK(cs_main);
+        mapHashedBlocks.clear();
+        mapHashedBlocks[chainActive.Tip()->nHeight] = GetTime(); //store a time stamp of when we last hashed on this block
     }
     return fKernelFound;
 }
@@ -5301,7 +5376,12 @@ bool CWallet::MintToTxIn(CZerocoinMint zerocoinSelected, int nSecurityLevel, con
     libzerocoin::AccumulatorWitness witness(Params().Zerocoin_Params(), accumulator, pubCoinSelected);
     string strFailReason = "";
     int nMintsAdded = 0;
-    if (!GenerateAccumulatorWitness(pubCoinSelected, accumulator, witness, nSecurityLevel, nMintsAdded, strFailReason, pindexCheckpoint)) {
+    CCoinWitnessData witnessData(pubCoinSelected.getValue(), denomination);
+    zTracker->GetWitnessData(witnessData.GetPubcoinHash(), witnessData);
+    bool fWitnessGenerated = GenerateAccumulatorWitness(pubCoinSelected, accumulator, witness, nSecurityLevel, nMintsAdded,
+            strFailReason, pindexCheckpoint, &witnessData);
+    zTracker->SetWitnessData(witnessData);
+    if (!fWitnessGenerated) {
         receipt.SetStatus(_("Try to spend with a higher security level to include more coins"), ZFAILED_ACCUMULATOR_INITIALIZATION);
         return error("%s : %s", __func__, receipt.GetStatusMessage());
     }
@@ -1276,3 +1276,66 @@ std::list<CDeterministicMint> WalletBatch::ListArchivedDeterministicMints()
 
     return listMints;
 }
+
+bool WalletBatch::WriteWitnessData(const CCoinWitnessData& witnessData)
+{
+    return WriteIC(std::make_pair(std::string("zwitness"), witnessData.GetPubcoinHash()), witnessData);
+}
+
+bool WalletBatch::EraseWitnessData(const uint256& hashPubcoin)
+{
+    return EraseIC(std::make_pair(std::string("zwitness"), hashPubcoin));
+}
+
+std::list<CCoinWitnessData> WalletBatch::ListWitnessData()
+{
+    std::list<CCoinWitnessData> listWitnessData;
+
+    try {
+        int nMinVersion = 0;
+        if (m_batch.Read((std::string)"minversion", nMinVersion))
+        {
+            if (nMinVersion > FEATURE_LATEST)
+                return listWitnessData;
+        }
+
+        // Get cursor
+        Dbc* pcursor = m_batch.GetCursor();
+        if (!pcursor)
+        {
+            return listWitnessData;
+        }
+
+        while (true)
+        {
+            // Read next record
+            CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+            CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+            int ret = m_batch.ReadAtCursor(pcursor, ssKey, ssValue);
+            if (ret == DB_NOTFOUND)
+                break;
+            else if (ret != 0) {
+                break;
+            }
+
+            std::string strType;
+            ssKey >> strType;
+            if (strType == "zwitness") {
+                uint256 hashPubcoin;
+                ssKey >> hashPubcoin;
+
+                CCoinWitnessData witnessData;
+                ssValue >> witnessData;
+
+                listWitnessData.emplace_back(witnessData);
+            }
+        }
+
+        pcursor->close();
+    }
+    catch (...) {
+        throw;
+    }
+
+    return listWitnessData;
+}
@@ -280,6 +280,9 @@ public:
     bool ReadZCount(uint32_t &nCount);
     std::map<CKeyID, std::vector<std::pair<uint256, uint32_t> > > MapMintPool();
     bool WriteMintPoolPair(const CKeyID& hashMasterSeed, const uint256& hashPubcoin, const uint32_t& nCount);
+    bool WriteWitnessData(const CCoinWitnessData& witnessData);
+    bool EraseWitnessData(const uint256& hashPubcoin);
+    std::list<CCoinWitnessData> ListWitnessData();
 protected:
     BerkeleyBatch m_batch;
     WalletDatabase& m_database;